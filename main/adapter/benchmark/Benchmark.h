@@ -0,0 +1,39 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+namespace benchmark {
+
+/** Number of heap allocations, counted by the global operator new of the benchmark executable. */
+extern std::atomic<size_t> allocationCount;
+
+/**
+ * Runs a function repeatedly for at least minDuration and prints the time and heap allocations per call.
+ * @param name name printed in the report
+ * @param function the function to measure, called once per iteration
+ */
+template <typename Function>
+void run(char const* name, Function&& function,
+         std::chrono::milliseconds minDuration = std::chrono::milliseconds(500)) {
+    function(); // warm up caches and lazily initialized state
+    size_t iterations = 0;
+    size_t allocations = allocationCount;
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::steady_clock::duration::zero();
+    while (elapsed < minDuration) {
+        for (int i = 0; i < 100; i++) {
+            function();
+        }
+        iterations += 100;
+        elapsed = std::chrono::steady_clock::now() - start;
+    }
+    allocations = allocationCount - allocations;
+    double nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    std::printf("%-45s %12.1f ns/frame %10.2f allocs/frame %12zu frames\n", name, nanos / iterations,
+                static_cast<double>(allocations) / iterations, iterations);
+}
+
+} // namespace benchmark
@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include "Benchmark.h"
+#include "BoardTranslator.h"
+#include "CertaboBoardMessageParser.h"
+#include "CertaboParser.h"
+#include "ChessData.h"
+#include "Chess0x88.h"
+#include "ChessnutConverter.h"
+#include "RgbLedCommandTranslator.h"
+#include "Sentio.h"
+
+std::atomic<size_t> benchmark::allocationCount{0};
+
+void* operator new(size_t size) {
+    benchmark::allocationCount++;
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+/** Board with piece recognition in the initial position, as recorded from a Certabo board. */
+std::string const PIECE_FRAME(
+    ":48 0 248 71 99 48 0 248 85 159 48 0 177 203 192 48 0 177 215 17 48 0 177 117 59 48 0 177 43 7 48 0 248 "
+    "222 81 48 0 247 200 86 48 0 248 114 180 48 0 248 155 251 48 0 248 48 74 48 0 177 236 131 48 0 177 230 12 "
+    "48 0 177 187 36 48 0 248 146 97 48 0 248 89 231 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 "
+    "0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 "
+    "0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 "
+    "0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 48 0 248 85 122 48 0 248 68 117 48 0 248 201 109 "
+    "48 0 248 144 65 48 0 177 231 217 48 0 248 76 179 48 0 248 161 89 48 0 94 124 14 48 0 248 98 180 48 0 248 "
+    "233 43 48 0 248 86 247 48 0 248 145 6 48 0 248 104 144 48 0 248 79 194 48 0 248 134 85 48 0 177 81 "
+    "73\r\n");
+
+/** Board without piece recognition in the initial position. */
+std::string const OCCUPANCY_FRAME(":255 255 0 0 0 0 255 255\r\n");
+
+class NullTranslator : public eboard::BoardTranslator {
+  public:
+    void hasPieceRecognition(bool) override {}
+    void translate(eboard::CertaboBoard const&) override {}
+    void translateOccupiedSquares(uint64_t) override {}
+    void ledsDetected(bool) override {}
+};
+
+/** Records the last piece frame so translate can be measured without the parser. */
+class RecordingTranslator : public NullTranslator {
+  public:
+    void translate(eboard::CertaboBoard const& board) override {
+        lastBoard = board;
+    }
+
+    eboard::CertaboBoard lastBoard;
+};
+
+chess::Bitboard occupiedSquares(char const* fen) {
+    chess::Chess0x88 board;
+    board.parse_fen(fen);
+    return board.getOccupancy();
+}
+
+std::array<eboard::StoneId, 64> const STANDARD_POSITION{2,   3,   4,   5,   6,   4,   3,   2,   //
+                                                        1,   1,   1,   1,   1,   1,   1,   1,   //
+                                                        0,   0,   0,   0,   0,   0,   0,   0,   //
+                                                        0,   0,   0,   0,   0,   0,   0,   0,   //
+                                                        0,   0,   0,   0,   0,   0,   0,   0,   //
+                                                        0,   0,   0,   0,   0,   0,   0,   0,   //
+                                                        129, 129, 129, 129, 129, 129, 129, 129, //
+                                                        130, 131, 132, 133, 134, 132, 131, 130};
+
+} // namespace
+
+int main() {
+    {
+        NullTranslator translator;
+        eboard::CertaboParser parser(translator);
+        auto data = reinterpret_cast<const uint8_t*>(PIECE_FRAME.data());
+        benchmark::run("CertaboParser::parse (pieces)", [&]() {
+            parser.parse(data, PIECE_FRAME.size());
+        });
+        // USB delivers at most 64 bytes per transfer
+        benchmark::run("CertaboParser::parse (pieces, 64 byte chunks)", [&]() {
+            for (size_t pos = 0; pos < PIECE_FRAME.size(); pos += 64) {
+                parser.parse(data + pos, std::min<size_t>(64, PIECE_FRAME.size() - pos));
+            }
+        });
+        benchmark::run("CertaboParser::parse (pieces, byte by byte)", [&]() {
+            for (size_t pos = 0; pos < PIECE_FRAME.size(); pos++) {
+                parser.parse(data + pos, 1);
+            }
+        });
+        auto occupancy = reinterpret_cast<const uint8_t*>(OCCUPANCY_FRAME.data());
+        benchmark::run("CertaboParser::parse (occupancy)", [&]() {
+            parser.parse(occupancy, OCCUPANCY_FRAME.size());
+        });
+    }
+    {
+        RecordingTranslator recorder;
+        eboard::CertaboParser parser(recorder);
+        parser.parse(reinterpret_cast<const uint8_t*>(PIECE_FRAME.data()), PIECE_FRAME.size());
+        volatile size_t sent = 0;
+        eboard::CertaboBoardMessageParser messageParser(
+            [&sent](std::array<eboard::StoneId, 64> const&) {
+                sent++;
+            },
+            [](bool) {}, [](bool) {});
+        benchmark::run("CertaboBoardMessageParser::translate", [&]() {
+            messageParser.translate(recorder.lastBoard);
+        });
+    }
+    {
+        auto initial = occupiedSquares("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+        auto afterE4 = occupiedSquares("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1");
+        eboard::Sentio sentio([](std::array<eboard::StoneId, 64> const&) {});
+        sentio.occupiedSquares(initial);
+        benchmark::run("Sentio::occupiedSquares (unchanged)", [&]() {
+            sentio.occupiedSquares(initial);
+        });
+        benchmark::run("Sentio::occupiedSquares (e2e4, new instance)", [&]() {
+            eboard::Sentio moveSentio([](std::array<eboard::StoneId, 64> const&) {});
+            moveSentio.occupiedSquares(afterE4);
+        });
+    }
+    {
+        chess::Chess0x88 board;
+        board.parse_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+        volatile size_t moves = 0;
+        benchmark::run("Chess0x88::generate_moves", [&]() {
+            moves += board.generate_moves().size();
+        });
+    }
+    {
+        volatile size_t sent = 0;
+        eboard::ChessnutConverter converter(
+            [&sent](uint8_t*, size_t) {
+                sent++;
+            },
+            [](uint8_t*, size_t) {});
+        std::vector<uint8_t> realTimeMode{0x21, 0x01, 0x00};
+        eboard::LedCommand ledCommand;
+        converter.chessnutToCertaboCommand(realTimeMode.data(), realTimeMode.size(), ledCommand);
+        auto afterE4 = STANDARD_POSITION;
+        afterE4[12] = eboard::ChessData::NO_STONE;
+        afterE4[28] = eboard::ChessData::WHITE_PAWN;
+        bool toggle = false;
+        benchmark::run("ChessnutConverter::process", [&]() {
+            converter.process((toggle = !toggle) ? afterE4 : STANDARD_POSITION);
+        });
+    }
+    {
+        eboard::RgbLedCommandTranslator translator;
+        eboard::LedCommand e2e4{0, 0, 0, 0, 0x10, 0, 0x10, 0};
+        eboard::LedCommand d2d4{0, 0, 0, 0, 0x08, 0, 0x08, 0};
+        bool toggle = false;
+        benchmark::run("RgbLedCommandTranslator::translate", [&]() {
+            translator.translate((toggle = !toggle) ? e2e4 : d2d4);
+        });
+    }
+    return 0;
+}
@@ -0,0 +1,142 @@
+/**
+ * Fuzz target for the framing of CertaboParser.
+ *
+ * Every input is parsed as a whole, byte by byte and in chunks of varying size. All three must report the same
+ * frames in the same order, and no more frames than the input has frame starts, so no frame is lost or duplicated
+ * at a chunk boundary.
+ *
+ * With -DCER2NUT_FUZZ=ON and clang the target is built with libFuzzer:
+ *
+ *   certabo-parser-fuzzer -max_len=4096 <corpus directory>
+ *
+ * Otherwise it runs the inputs given as files, or stdin for AFL, and reports the parsed frames per second:
+ *
+ *   certabo-parser-fuzzer <input file>...
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "BoardTranslator.h"
+#include "CertaboParser.h"
+
+namespace {
+
+/** Records every call of the parser, a board by a hash of its piece keys. */
+class RecordingTranslator : public eboard::BoardTranslator {
+  public:
+    enum Call { PIECE_RECOGNITION, PIECES, OCCUPANCY, LEDS };
+
+    void hasPieceRecognition(bool pieceRecognition) override {
+        calls.emplace_back(PIECE_RECOGNITION, pieceRecognition);
+    }
+
+    void translate(eboard::CertaboBoard const& board) override {
+        uint64_t hash = 0;
+        for (eboard::CertaboPiece const& piece : board) {
+            hash = (hash ^ piece.getKey()) * 0x100000001B3ULL;
+        }
+        calls.emplace_back(PIECES, hash);
+        frames++;
+    }
+
+    void translateOccupiedSquares(uint64_t occupied) override {
+        calls.emplace_back(OCCUPANCY, occupied);
+        frames++;
+    }
+
+    void ledsDetected(bool hasRgbLeds) override {
+        calls.emplace_back(LEDS, hasRgbLeds);
+    }
+
+    std::vector<std::pair<Call, uint64_t>> calls;
+    size_t frames = 0;
+};
+
+/** @return number of frame starts, each ':' and each "\r\n" terminator starts a new frame */
+size_t countFrameStarts(uint8_t const* data, size_t size) {
+    size_t starts = 1;
+    bool carriageReturn = false;
+    for (size_t i = 0; i < size; i++) {
+        if (data[i] == ':' || (data[i] == '\n' && carriageReturn)) {
+            starts++;
+        }
+        carriageReturn = data[i] == '\r';
+    }
+    return starts;
+}
+
+size_t parsedFrames = 0;
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(uint8_t const* data, size_t size) {
+    RecordingTranslator whole;
+    eboard::CertaboParser(whole).parse(data, size);
+
+    RecordingTranslator byteByByte;
+    eboard::CertaboParser byteParser(byteByByte);
+    for (size_t i = 0; i < size; i++) {
+        byteParser.parse(data + i, 1);
+    }
+
+    // chunk sizes from 1 to 64 bytes like USB transfers, derived from the input so a crash is reproducible
+    RecordingTranslator chunked;
+    eboard::CertaboParser chunkParser(chunked);
+    uint32_t random = static_cast<uint32_t>(size) * 2654435761U;
+    for (size_t pos = 0; pos < size;) {
+        random = random * 1664525U + 1013904223U;
+        size_t chunk = std::min<size_t>((random >> 26) + 1, size - pos);
+        chunkParser.parse(data + pos, chunk);
+        pos += chunk;
+    }
+
+    if (byteByByte.calls != whole.calls || chunked.calls != whole.calls ||
+        whole.frames > countFrameStarts(data, size)) {
+        std::abort();
+    }
+    parsedFrames += whole.frames;
+    return 0;
+}
+
+#ifdef CER2NUT_FUZZ_STANDALONE
+
+static bool runInput(std::istream& in) {
+    std::vector<uint8_t> input((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (!in.good() && !in.eof()) {
+        return false;
+    }
+    LLVMFuzzerTestOneInput(input.data(), input.size());
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    auto start = std::chrono::steady_clock::now();
+    if (argc < 2 && !runInput(std::cin)) {
+        std::cerr << "cannot read stdin" << std::endl;
+        return 1;
+    }
+    for (int i = 1; i < argc; i++) {
+        std::ifstream in(argv[i], std::ios::binary);
+        if (!in || !runInput(in)) {
+            std::cerr << "cannot read " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+    double micros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start)
+                        .count();
+    // each input is parsed three times
+    std::cout << parsedFrames << " frames in " << micros / 1000.0 << " ms, "
+              << static_cast<uint64_t>(parsedFrames * 3 * 1000000 / std::max(1.0, micros)) << " frames/s" << std::endl;
+    return 0;
+}
+
+#endif
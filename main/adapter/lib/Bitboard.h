@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace chess {
+
+/**
+ * Occupancy of the 64 squares, bit n is set if square n is occupied. Square 0 is a8, square 63 is h1.
+ */
+using Bitboard = uint64_t;
+
+inline Bitboard squareMask(int square) {
+    return Bitboard{1} << square;
+}
+
+/** @return number of squares in the bitboard */
+inline int popCount(Bitboard bitboard) {
+    return __builtin_popcountll(bitboard);
+}
+
+/** @return the lowest square in the bitboard, which must not be empty */
+inline int lowestSquare(Bitboard bitboard) {
+    return __builtin_ctzll(bitboard);
+}
+
+/**
+ * Fibonacci hashing, multiply by 2^64 divided by the golden ratio and keep the upper bits of the product, which are
+ * well mixed.
+ * @param key e.g. a bitboard or a piece key
+ * @param bits number of bits of the hash, 1..64
+ * @return hash in 0..2^bits - 1
+ */
+inline uint64_t fibonacciHash(uint64_t key, unsigned bits) {
+    return (key * 0x9E3779B97F4A7C15ULL) >> (64 - bits);
+}
+
+/**
+ * Reverse the bits of a byte
+ * 01000000 becomes 00000010
+ * @param b input byte
+ * @return byte with its bits reversed
+ * Taken from https://graphics.stanford.edu/~seander/bithacks.html#ReverseByteWith64BitsDiv
+ */
+inline uint8_t reverseBits(uint8_t b) {
+    return (b * 0x0202020202ULL & 0x010884422010ULL) % 1023;
+}
+
+} // namespace chess
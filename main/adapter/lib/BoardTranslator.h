@@ -1,7 +1,7 @@
 #pragma once
 
 #include <array>
-#include <vector>
+#include <cstdint>
 
 #include "CertaboPiece.h"
 
@@ -15,9 +15,13 @@ class BoardTranslator {
   public:
     virtual void hasPieceRecognition(bool canRecognize) = 0;
 
-    virtual void translate(std::vector<CertaboPiece> const& board) = 0;
+    virtual void translate(CertaboBoard const& board) = 0;
 
-    virtual void translateOccupiedSquares(std::array<bool, 64> const& occupied) = 0;
+    /**
+     * Translate the occupied squares of a board without piece recognition.
+     * @param occupied bit n is set if square n is occupied, square 0 is a8
+     */
+    virtual void translateOccupiedSquares(uint64_t occupied) = 0;
 
     virtual void ledsDetected(bool hasRgbLeds) = 0;
 };
@@ -1,6 +1,4 @@
 #include <functional>
-#include <map>
-#include <vector>
 
 #include "CalibrationSquare.h"
 #include "ChessData.h"
@@ -18,26 +16,46 @@ static int toSquare(int b) {
     return row * 8 + col;
 }
 
-void eboard::CalibrationSquare::calibratePiece(std::vector<std::vector<CertaboPiece>>& receivedBoards,
+void eboard::CalibrationSquare::calibratePiece(CertaboPiece const& pc,
                                                CalibrationCompleteForSquareFunction const& completeForSquareFunction) {
-    std::map<CertaboPiece, int> pieceCount;
-    for (auto& board : receivedBoards) {
-        CertaboPiece& pc = board[square];
-        pieceCount[pc]++;
-    }
-    for (auto& entry : pieceCount) {
-        int count = entry.second;
-        auto& pc = const_cast<CertaboPiece&>(entry.first);
-        if (count > receivedBoards.size() / 2 && pieceOrExtraQueenSquare(pc)) {
-            piece = CertaboPiece(pc.getId());
-            if (pc.getId() != PieceId{}) {
-                completeForSquareFunction(toSquare(square));
+    countPiece(pc);
+    if (frames >= MIN_FRAMES) {
+        for (Candidate const& candidate : candidates) {
+            if (candidate.count * 2 > frames && pieceOrExtraQueenSquare(candidate.piece)) {
+                piece = candidate.piece;
+                if (piece.getId() != PieceId{}) {
+                    completeForSquareFunction(toSquare(square));
+                }
+                return;
             }
         }
     }
+    if (frames > MAX_FRAMES) {
+        frames /= 2;
+        for (Candidate& candidate : candidates) {
+            candidate.count /= 2;
+        }
+    }
+}
+
+void eboard::CalibrationSquare::countPiece(CertaboPiece const& pc) {
+    frames++;
+    Candidate* weakest = &candidates[0];
+    for (Candidate& candidate : candidates) {
+        if (candidate.count > 0 && candidate.piece == pc) {
+            candidate.count++;
+            return;
+        }
+        if (candidate.count < weakest->count) {
+            weakest = &candidate;
+        }
+    }
+    // a free slot has a count of zero, otherwise the least seen piece is replaced
+    weakest->piece = pc;
+    weakest->count = 1;
 }
 
-bool eboard::CalibrationSquare::pieceOrExtraQueenSquare(CertaboPiece& pc) const {
+bool eboard::CalibrationSquare::pieceOrExtraQueenSquare(CertaboPiece const& pc) const {
     return pc.getId() != PieceId{} || square == 19 || square == 43;
 }
 
@@ -49,7 +67,7 @@ int eboard::CalibrationSquare::noStoneOr(int stone) {
     }
 }
 
-int eboard::CalibrationSquare::getStone() {
+int eboard::CalibrationSquare::startPositionStone(int square) {
     if (square > 7 && square < 16) {
         return ChessData::BLACK_PAWN;
     }
@@ -59,37 +77,45 @@ int eboard::CalibrationSquare::getStone() {
     switch (square) {
     case 0:
     case 7:
-        return noStoneOr(ChessData::BLACK_ROOK);
+        return ChessData::BLACK_ROOK;
     case 1:
     case 6:
-        return noStoneOr(ChessData::BLACK_KNIGHT);
+        return ChessData::BLACK_KNIGHT;
     case 2:
     case 5:
-        return noStoneOr(ChessData::BLACK_BISHOP);
+        return ChessData::BLACK_BISHOP;
     case 3:
     case 19: // black extra queen square
-        return noStoneOr(ChessData::BLACK_QUEEN);
+        return ChessData::BLACK_QUEEN;
     case 4:
-        return noStoneOr(ChessData::BLACK_KING);
+        return ChessData::BLACK_KING;
     case 56:
     case 63:
-        return noStoneOr(ChessData::WHITE_ROOK);
+        return ChessData::WHITE_ROOK;
     case 57:
     case 62:
-        return noStoneOr(ChessData::WHITE_KNIGHT);
+        return ChessData::WHITE_KNIGHT;
     case 58:
     case 61:
-        return noStoneOr(ChessData::WHITE_BISHOP);
+        return ChessData::WHITE_BISHOP;
     case 59:
     case 43: // white extra queen square
-        return noStoneOr(ChessData::WHITE_QUEEN);
+        return ChessData::WHITE_QUEEN;
     case 60:
-        return noStoneOr(ChessData::WHITE_KING);
+        return ChessData::WHITE_KING;
     default:
         return ChessData::NO_STONE;
     }
 }
 
+int eboard::CalibrationSquare::getStone() {
+    int stone = startPositionStone(square);
+    if (stone == ChessData::BLACK_PAWN || stone == ChessData::WHITE_PAWN) {
+        return stone;
+    }
+    return noStoneOr(stone);
+}
+
 eboard::CertaboPiece eboard::CalibrationSquare::getPiece() {
     return piece;
 }
@@ -1,7 +1,7 @@
 #pragma once
 
+#include <array>
 #include <functional>
-#include <vector>
 
 #include "CertaboPiece.h"
 
@@ -9,24 +9,48 @@ namespace eboard {
 
 using CalibrationCompleteForSquareFunction = std::function<void(int square)>;
 
+/**
+ * CalibrationSquare finds the piece on one square of the starting position.
+ * Each frame updates a small table of candidate pieces with running counts, no boards are stored.
+ */
 class CalibrationSquare {
   public:
+    static int const CANDIDATES = 4;
+    static int const MIN_FRAMES = 7;
+    static int const MAX_FRAMES = 15;
+
     explicit CalibrationSquare(int square);
 
     bool isCalibrated();
-    void calibratePiece(std::vector<std::vector<CertaboPiece>>& receivedBoards,
-                        CalibrationCompleteForSquareFunction const& completeForSquareFunction);
+    /**
+     * Count the piece seen on this square in a new frame. After MIN_FRAMES frames the square is calibrated
+     * as soon as one piece was seen in more than half of the counted frames. Once more than MAX_FRAMES frames
+     * are counted, all counts are halved so that older frames lose weight.
+     */
+    void calibratePiece(CertaboPiece const& pc, CalibrationCompleteForSquareFunction const& completeForSquareFunction);
     int getStone();
+    /**
+     * @return the stone on a square in the starting position, the extra queen squares have a queen
+     */
+    static int startPositionStone(int square);
     int getSquare() const;
 
     eboard::CertaboPiece getPiece();
 
   private:
-    bool pieceOrExtraQueenSquare(CertaboPiece& pc) const;
+    struct Candidate {
+        CertaboPiece piece;
+        uint8_t count = 0;
+    };
+
+    void countPiece(CertaboPiece const& pc);
+    bool pieceOrExtraQueenSquare(CertaboPiece const& pc) const;
     int noStoneOr(int stone);
 
     int square;
     CertaboPiece piece;
+    std::array<Candidate, CANDIDATES> candidates{};
+    int frames = 0;
 };
 
 } // namespace eboard
\ No newline at end of file
@@ -1,11 +1,11 @@
-#include <algorithm>
-#include <unordered_map>
-
 #include "CertaboBoardMessageParser.h"
 #include "ChessData.h"
+#include "Profiler.h"
 #include "Sentio.h"
 
 using eboard::CertaboBoardMessageParser;
+using eboard::ProfileStage;
+using eboard::Profiler;
 using eboard::Sentio;
 
 CertaboBoardMessageParser::CertaboBoardMessageParser(CallbackFunction callbackFunction,
@@ -13,6 +13,7 @@ CertaboBoardMessageParser::CertaboBoardMessageParser(CallbackFunction callbackFu
                                                      LedsDetectedFunction ledsDetectedFunction)
     : parser(CertaboParser(*this)), callback(std::move(callbackFunction)),
       sentio(Sentio([this](std::array<StoneId, 64> board) {
+          Profiler::mark(ProfileStage::TRANSLATED);
           callback(board);
       })),
       pieceRecognitionCallback(std::move(pieceRecognitionCallbackFunction)),
@@ -26,22 +27,19 @@ void CertaboBoardMessageParser::hasPieceRecognition(bool canRecognize) {
     pieceRecognitionCallback(canRecognize);
 }
 
-void CertaboBoardMessageParser::translate(std::vector<CertaboPiece> const& board) {
+void CertaboBoardMessageParser::translate(CertaboBoard const& board) {
     std::array<StoneId, 64> newBoard = {};
     int i = 0;
     for (auto& piece : board) {
-        int square = toSquare(i);
-        if (stones.find(piece) != stones.end()) {
-            newBoard[square] = stones[piece];
-        } else {
-            newBoard[square] = ChessData::NO_STONE;
-        }
+        newBoard[toSquare(i)] = stones.find(piece);
         i++;
     }
-    averageLastBoards(newBoard);
+    std::array<StoneId, 64> const& filtered = majorityFilter.filter(newBoard);
+    Profiler::mark(ProfileStage::TRANSLATED);
+    callback(filtered);
 }
 
-void CertaboBoardMessageParser::translateOccupiedSquares(std::array<bool, 64> const& occupied) {
+void CertaboBoardMessageParser::translateOccupiedSquares(uint64_t occupied) {
     sentio.occupiedSquares(occupied);
 }
 
@@ -49,34 +47,6 @@ void CertaboBoardMessageParser::ledsDetected(bool hasRgbLeds) {
     ledsDetectedFunction(hasRgbLeds);
 }
 
-void CertaboBoardMessageParser::averageLastBoards(std::array<StoneId, 64> const& newBoard) {
-    while (boardHistory.size() > 2) {
-        boardHistory.pop_front();
-    }
-    boardHistory.push_back(newBoard);
-    std::array<StoneId, 64> avg_board{};
-    for (int i = 0; i < 64; i++) {
-        std::vector<StoneId> counter;
-        for (const auto& board : boardHistory) {
-            counter.push_back(board[i]);
-        }
-        avg_board[i] = mostFrequent(counter);
-    }
-    callback(avg_board);
-}
-using MapEntry = std::pair<uint8_t, std::size_t>;
-
-int CertaboBoardMessageParser::mostFrequent(std::vector<StoneId>& entries) {
-    std::unordered_map<StoneId, std::size_t> freqMap;
-    std::for_each(entries.begin(), entries.end(), [&](StoneId& elem) {
-        freqMap[elem]++;
-    });
-    auto result = std::max_element(freqMap.begin(), freqMap.end(), [](MapEntry left, MapEntry right) {
-        return left.second < right.second;
-    });
-    return result->first;
-}
-
 int CertaboBoardMessageParser::toSquare(int index) {
     int row = 7 - (index / 8);
     int col = index % 8;
@@ -86,3 +56,11 @@ int CertaboBoardMessageParser::toSquare(int index) {
 void CertaboBoardMessageParser::updateStones(eboard::Stones const& newStones) {
     stones = newStones;
 }
+
+void CertaboBoardMessageParser::setHistoryDepth(size_t depth) {
+    majorityFilter.setDepth(depth);
+}
+
+void CertaboBoardMessageParser::setDebounceSettings(DebounceSettings const& settings) {
+    sentio.setDebounceSettings(settings);
+}
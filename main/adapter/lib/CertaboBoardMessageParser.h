@@ -2,12 +2,11 @@
 
 #include <array>
 #include <cstdint>
-#include <list>
-#include <vector>
 
 #include "BoardTranslator.h"
 #include "CertaboCalibrator.h"
 #include "CertaboParser.h"
+#include "MajorityFilter.h"
 #include "Sentio.h"
 
 namespace eboard {
@@ -32,22 +31,23 @@ class CertaboBoardMessageParser : public BoardTranslator {
 
   public:
     void hasPieceRecognition(bool canRecognize) override;
-    void translate(std::vector<CertaboPiece> const& board) override;
-    void translateOccupiedSquares(std::array<bool, 64> const& occupied) override;
+    void translate(CertaboBoard const& board) override;
+    void translateOccupiedSquares(uint64_t occupied) override;
     void ledsDetected(bool hasRgbLeds) override;
 
     void parse(const uint8_t* msg, size_t data_len);
     void updateStones(Stones const& newStones);
-
-  private:
-    void averageLastBoards(std::array<StoneId, 64> const &newBoard);
     /**
-     * Returns the element with the highest frequency in a vector.
-     * implementation from https://devptr.com/find-most-frequent-element-in-vector-in-c/
-     * @param entries
-     * @return
+     * Set the number of boards used for the per-square majority vote, e.g. 3, 5 or 7.
+     * More boards reject more noise but add latency.
+     */
+    void setHistoryDepth(size_t depth);
+    /**
+     * Set the limits for debouncing the occupied squares of boards without piece recognition.
      */
-    static int mostFrequent(std::vector<StoneId>& entries);
+    void setDebounceSettings(DebounceSettings const& settings);
+
+  private:
     static int toSquare(int index);
 
     CertaboParser parser;
@@ -56,7 +56,7 @@ class CertaboBoardMessageParser : public BoardTranslator {
     Sentio sentio;
     PieceRecognitionCallbackFunction pieceRecognitionCallback;
     LedsDetectedFunction ledsDetectedFunction;
-    std::list<std::array<StoneId, 64>> boardHistory;
+    MajorityFilter majorityFilter;
 };
 
 } // namespace eboard
\ No newline at end of file
@@ -29,23 +29,30 @@ void CertaboCalibrator::hasPieceRecognition(bool) {
     // ignore
 }
 
-void CertaboCalibrator::translate(std::vector<CertaboPiece> const& board) {
-    receivedBoards.push_back(board);
-    if (receivedBoards.size() >= 7 && !calibrationComplete) {
-        if (checkPieces()) {
-            receivedBoards.clear();
-            Stones stones;
-            for (CalibrationSquare square : calibrationSquares) {
-                int stone = square.getStone();
-                if (stone != ChessData::NO_STONE) {
-                    stones[square.getPiece()] = stone;
-                }
-            }
+void CertaboCalibrator::setStoredStones(Stones const& stones) {
+    storedStones = stones;
+    hasStoredStones = true;
+}
+
+void CertaboCalibrator::translate(CertaboBoard const& board) {
+    if (hasStoredStones && !calibrationComplete) {
+        hasStoredStones = false;
+        if (matchesStoredStones(board)) {
             calibrationComplete = true;
-            completeFunction(stones);
-        } else if (receivedBoards.size() > 15) {
-            receivedBoards.erase(receivedBoards.begin(), receivedBoards.end() - 10);
+            completeFunction(storedStones);
+            return;
+        }
+    }
+    if (!calibrationComplete && checkPieces(board)) {
+        Stones stones;
+        for (CalibrationSquare& square : calibrationSquares) {
+            int stone = square.getStone();
+            if (stone != ChessData::NO_STONE) {
+                stones.insert(square.getPiece(), stone);
+            }
         }
+        calibrationComplete = true;
+        completeFunction(stones);
     }
 }
 
@@ -53,11 +60,11 @@ void CertaboCalibrator::ledsDetected(bool hasRgbLeds) {
     ledsDetectedFunction(hasRgbLeds);
 }
 
-bool CertaboCalibrator::checkPieces() {
+bool CertaboCalibrator::checkPieces(CertaboBoard const& board) {
     bool allCalibrated = true;
     for (CalibrationSquare& square : calibrationSquares) {
         if (!square.isCalibrated()) {
-            square.calibratePiece(receivedBoards, completeForSquareFunction);
+            square.calibratePiece(board[square.getSquare()], completeForSquareFunction);
             if (!square.isCalibrated()) {
                 allCalibrated = false;
             }
@@ -65,3 +72,16 @@ bool CertaboCalibrator::checkPieces() {
     }
     return allCalibrated;
 }
+
+bool CertaboCalibrator::matchesStoredStones(CertaboBoard const& board) const {
+    for (CalibrationSquare const& square : calibrationSquares) {
+        int index = square.getSquare();
+        int expected = CalibrationSquare::startPositionStone(index);
+        int stone = storedStones.find(board[index]);
+        bool extraQueenSquare = index == 19 || index == 43;
+        if (stone != expected && !(extraQueenSquare && board[index].getKey() == 0)) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -1,19 +1,14 @@
 #pragma once
 
 #include <functional>
-#include <map>
 
 #include "BoardTranslator.h"
 #include "CalibrationSquare.h"
 #include "CertaboParser.h"
+#include "Stones.h"
 
 namespace eboard {
 
-using StoneId = uint8_t;
-/**
- * Maps raw Certabo piece IDs to individual chess stones.
- */
-using Stones = std::map<CertaboPiece, StoneId>;
 /**
  * Function to be called when calibration is complete.
  */
@@ -46,9 +41,9 @@ class CertaboCalibrator : public BoardTranslator {
      * Function called by the used parser to translate the raw piece information.
      * @param board parsed board with raw piece information
      */
-    void translate(std::vector<CertaboPiece> const& board) override;
+    void translate(CertaboBoard const& board) override;
 
-    void translateOccupiedSquares(std::array<bool, 64> const& board) override {
+    void translateOccupiedSquares(uint64_t occupied) override {
         // ignore
     };
 
@@ -62,16 +57,25 @@ class CertaboCalibrator : public BoardTranslator {
      */
     void calibrate(const uint8_t* data, size_t data_len);
 
+    /**
+     * Set stones of a previous calibration.
+     * If the first received board matches the starting position with these stones, calibration is complete
+     * immediately. Otherwise the stones are discarded and the board is calibrated as usual.
+     */
+    void setStoredStones(Stones const& stones);
+
   private:
-    bool checkPieces();
+    bool checkPieces(CertaboBoard const& board);
+    bool matchesStoredStones(CertaboBoard const& board) const;
 
     CalibrationCompleteFunction completeFunction;
     CalibrationCompleteForSquareFunction completeForSquareFunction;
     LedsDetectedFunction ledsDetectedFunction;
     CertaboParser parser;
-    std::vector<std::vector<CertaboPiece>> receivedBoards;
     bool calibrationComplete = false;
     std::vector<CalibrationSquare> calibrationSquares;
+    Stones storedStones;
+    bool hasStoredStones = false;
 };
 
 } // namespace eboard
\ No newline at end of file
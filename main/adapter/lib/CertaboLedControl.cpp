@@ -2,7 +2,7 @@
 
 using eboard::CertaboLedControl;
 
-std::vector<uint8_t> const CertaboLedControl::LEDS_OFF{0, 0, 0, 0, 0, 0, 0, 0};
+eboard::LedCommand const CertaboLedControl::LEDS_OFF{0, 0, 0, 0, 0, 0, 0, 0};
 
 CertaboLedControl::CertaboLedControl(ToUsbFunction toUsb)
     : toUsb(std::move(toUsb)), processingTimeMs(600), keepRunning(true), ledsInitiallyDetected(false),
@@ -11,71 +11,123 @@ CertaboLedControl::CertaboLedControl(ToUsbFunction toUsb)
 }
 
 CertaboLedControl::~CertaboLedControl() {
-    keepRunning = false;
+    {
+        std::lock_guard<std::mutex> guard(commandMutex);
+        keepRunning = false;
+    }
+    commandCondition.notify_all();
     if (processingThread.joinable()) {
         processingThread.join();
     }
 }
 
-void CertaboLedControl::ledCommand(std::vector<uint8_t> const& command) {
-    std::lock_guard<std::mutex> guard(commandMutex);
-    pendingCommands.push_back(command);
+void CertaboLedControl::ledCommand(LedCommand const& command) {
+    {
+        std::lock_guard<std::mutex> guard(commandMutex);
+        if (pendingCount == pendingCommands.size()) {
+            pendingCommands[0].swap(pendingCommands[1]);
+            pendingCount--;
+        }
+        pendingCommands[pendingCount++] = command;
+        // a command followed by LEDS_OFF is kept so a short blink is still shown, otherwise the latest command wins
+        if (pendingCount == 2 && pendingCommands[1] != LEDS_OFF) {
+            pendingCommands[0].swap(pendingCommands[1]);
+            pendingCount--;
+        }
+    }
+    commandCondition.notify_all();
 }
 
 void CertaboLedControl::setProcessingTime(int processingTimeMillis) {
-    processingTimeMs = processingTimeMillis;
+    {
+        std::lock_guard<std::mutex> guard(commandMutex);
+        processingTimeMs = processingTimeMillis;
+    }
+    commandCondition.notify_all();
 }
 
 void CertaboLedControl::processCommands() {
     processingThread = std::thread([this]() {
+        std::unique_lock<std::mutex> lock(commandMutex);
         while (keepRunning) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-            std::lock_guard<std::mutex> guard(commandMutex);
-            while (pendingCommands.size() > 2) {
-                pendingCommands.pop_front();
+            if (pendingCount == 0) {
+                commandCondition.wait(lock, [this]() {
+                    return pendingCount > 0 || !keepRunning;
+                });
+                continue;
             }
-            if (pendingCommands.size() == 2 && pendingCommands.back() != LEDS_OFF) {
-                pendingCommands.pop_front();
+            auto due = lastCommandTime + std::chrono::milliseconds(processingTimeMs);
+            if (std::chrono::steady_clock::now() < due) {
+                // woken up early if the processing time changes
+                commandCondition.wait_until(lock, due);
+                continue;
             }
-            uint64_t currentTime = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                       std::chrono::steady_clock::now().time_since_epoch())
-                                       .count();
-            if ((lastCommandTime + processingTimeMs) <= currentTime && !pendingCommands.empty()) {
-                auto cmd = pendingCommands.front();
-                if (cmd != lastCommand) {
-                    if (ledsInitiallyDetected) {
-                        if (hasRgbLeds) {
-                            auto translatedCommand = ledCommandTranslator.translate(cmd);
-                            toUsb(&translatedCommand.front(), translatedCommand.size());
-                        } else {
-                            toUsb(&cmd.front(), cmd.size());
-                        }
-                    } else {
-                        std::this_thread::sleep_for(std::chrono::milliseconds(200));
-                        toUsb(&cmd.front(), cmd.size());
-                        std::this_thread::sleep_for(std::chrono::milliseconds(400));
-                        if ((!ledsInitiallyDetected && !hasRgbLeds) || hasRgbLeds) {
-                            auto translatedCommand = ledCommandTranslator.translate(cmd);
-                            toUsb(&translatedCommand.front(), translatedCommand.size());
-                        }
-                    }
-                    lastCommand = cmd;
-                    lastCommandTime = currentTime;
-                }
-                pendingCommands.pop_front();
+            LedCommand cmd = pendingCommands[0];
+            pendingCommands[0].swap(pendingCommands[1]);
+            pendingCount--;
+            if (!commandSent || cmd != lastCommand) {
+                sendCommand(cmd, lock);
+                lastCommand = cmd;
+                commandSent = true;
+                lastCommandTime = std::chrono::steady_clock::now();
             }
         }
     });
 }
 
+void CertaboLedControl::sendCommand(LedCommand& cmd, std::unique_lock<std::mutex>& lock) {
+    auto stopped = [this]() {
+        return !keepRunning;
+    };
+    if (ledsInitiallyDetected) {
+        lock.unlock();
+        if (hasRgbLeds) {
+            sendRgbCommand(cmd);
+        } else {
+            toUsb(cmd.data(), cmd.size());
+        }
+        lock.lock();
+    } else {
+        if (commandCondition.wait_for(lock, std::chrono::milliseconds(200), stopped)) {
+            return;
+        }
+        lock.unlock();
+        toUsb(cmd.data(), cmd.size());
+        lock.lock();
+        // the board answers with its LED type, stop waiting as soon as it is known
+        commandCondition.wait_for(lock, std::chrono::milliseconds(400), [this]() {
+            return ledsInitiallyDetected || !keepRunning;
+        });
+        if (!keepRunning) {
+            return;
+        }
+        if ((!ledsInitiallyDetected && !hasRgbLeds) || hasRgbLeds) {
+            lock.unlock();
+            sendRgbCommand(cmd);
+            lock.lock();
+        }
+    }
+}
+
+void CertaboLedControl::sendRgbCommand(LedCommand const& cmd) {
+    if (ledCommandTranslator.translate(cmd)) {
+        RgbLedCommandTranslator::Frame frame = ledCommandTranslator.getFrame();
+        toUsb(frame.data(), frame.size());
+    }
+}
+
 void CertaboLedControl::ledsDetected(bool rgbLeds) {
-    hasRgbLeds = rgbLeds;
-    if (!ledsInitiallyDetected && hasRgbLeds) {
-        processingTimeMs = 200;
+    {
+        std::lock_guard<std::mutex> guard(commandMutex);
+        hasRgbLeds = rgbLeds;
+        if (!ledsInitiallyDetected && hasRgbLeds) {
+            processingTimeMs = 200;
+        }
+        ledsInitiallyDetected = true;
     }
-    ledsInitiallyDetected = true;
+    commandCondition.notify_all();
 }
 
 void CertaboLedControl::setBrightness(int brightnessValue) {
     ledCommandTranslator.setBrightness(brightnessValue);
-}
\ No newline at end of file
+}
@@ -1,13 +1,14 @@
 #pragma once
 
 #include <atomic>
+#include <array>
 #include <chrono>
+#include <condition_variable>
 #include <functional>
-#include <list>
 #include <mutex>
 #include <thread>
-#include <vector>
 
+#include "LedCommand.h"
 #include "RgbLedCommandTranslator.h"
 
 namespace eboard {
@@ -17,6 +18,8 @@ using ToUsbFunction = std::function<void(uint8_t* data, size_t data_len)>;
 
 /**
  * CertaboLedControl ensures the Certabo board does not get flooded with LED commands.
+ * Pending commands are coalesced so only the latest one is sent, the processing thread sleeps until a command is
+ * queued and the processing time since the last command has passed.
  */
 class CertaboLedControl {
   public:
@@ -24,7 +27,7 @@ class CertaboLedControl {
 
     ~CertaboLedControl();
 
-    void ledCommand(std::vector<uint8_t> const& command);
+    void ledCommand(LedCommand const& command);
 
     void setProcessingTime(int processingTimeMillis);
 
@@ -34,18 +37,25 @@ class CertaboLedControl {
     void setBrightness(int brightnessValue);
 
   private:
-    static std::vector<uint8_t> const LEDS_OFF;
+    static LedCommand const LEDS_OFF;
     void processCommands();
+    void sendCommand(LedCommand& cmd, std::unique_lock<std::mutex>& lock);
+    /** Send the RGB frame for a command, nothing is sent if the frame did not change */
+    void sendRgbCommand(LedCommand const& cmd);
 
     ToUsbFunction toUsb;
-    std::list<std::vector<uint8_t>> pendingCommands;
+    /** at most two commands are pending: the latest one, preceded by a command that is followed by LEDS_OFF */
+    std::array<LedCommand, 2> pendingCommands{};
+    size_t pendingCount = 0;
     std::atomic_int processingTimeMs;
-    uint64_t lastCommandTime = 0;
-    std::vector<uint8_t> lastCommand;
+    std::chrono::steady_clock::time_point lastCommandTime;
+    LedCommand lastCommand{};
+    bool commandSent = false;
     std::atomic_bool keepRunning;
     std::atomic_bool ledsInitiallyDetected;
     std::atomic_bool hasRgbLeds;
     std::mutex commandMutex;
+    std::condition_variable commandCondition;
     std::thread processingThread;
     RgbLedCommandTranslator ledCommandTranslator;
 };
@@ -1,116 +1,110 @@
-#include <algorithm>
-
+#include "Bitboard.h"
 #include "CertaboParser.h"
 #include "CertaboPiece.h"
+#include "Profiler.h"
 
 using eboard::CertaboParser;
 using eboard::CertaboPiece;
+using eboard::ProfileStage;
+using eboard::Profiler;
 
 CertaboParser::CertaboParser(BoardTranslator& translator) : translator(translator) {}
 
-void CertaboParser::parse(const uint8_t* msg, size_t data_len) {
-    std::vector<uint8_t> data = buffer;
-    data.insert(data.end(), msg, msg + data_len);
-    buffer.clear();
-
-    if (data.size() > 15) {
-        std::string input_str(data.begin(), data.end());
-        if (input_str.find("\r\n") == std::string::npos) {
-            buffer.insert(buffer.end(), data.begin(), data.end());
-        } else {
-            std::vector<std::string> split_data = strSplit<std::string>(input_str, ":");
-            int index = 0;
-            for (auto& part : split_data) {
-                if (!part.empty() && !parsePart(part) && index == (split_data.size() - 1)) {
-                    size_t position = data.size() - part.size() - 1;
-                    buffer.insert(buffer.end(), data.begin() + static_cast<int>(position), data.end());
-                }
-                index++;
-            }
-        }
-    } else {
-        buffer = data;
+void CertaboParser::parse(const uint8_t* data, size_t data_len) {
+    for (size_t i = 0; i < data_len; i++) {
+        consume(data[i]);
     }
 }
 
-bool CertaboParser::parsePart(std::string& part) {
-    if (part.find('L') != std::string::npos) {
+void CertaboParser::consume(uint8_t c) {
+    switch (c) {
+    case ':':
+        startFrame();
+        break;
+    case '\r':
+        carriageReturn = true;
+        return;
+    case '\n':
+        // a single '\n' only wraps the line, values continue on the next line
+        if (carriageReturn) {
+            endFrame();
+        }
+        break;
+    case ' ':
+        endValue();
+        break;
+    case 'L':
         translator.ledsDetected(false);
-    } else if (part.find('D') != std::string::npos) {
+        break;
+    case 'D':
         translator.ledsDetected(true);
+        break;
+    default:
+        if (c >= '0' && c <= '9') {
+            currentValue = currentValue * 10 + (c - '0');
+            inValue = true;
+            if (currentValue > 255) {
+                discarding = true;
+            }
+        } else {
+            discarding = true;
+        }
+        break;
     }
-    part.erase(std::remove_if(part.begin(), part.end(),
-                              [](unsigned char x) {
-                                  return (x == '\r' || x == '\n' || x == 'L' || x == 'D');
-                              }),
-               part.end());
-    std::vector<std::string> split_input = strSplit<std::string>(part, " ");
-    if (!pieceRecognition && split_input.size() > 8) {
-        pieceRecognition = true;
-        translator.hasPieceRecognition(true);
+    carriageReturn = false;
+}
+
+void CertaboParser::startFrame() {
+    valueCount = 0;
+    currentValue = 0;
+    inValue = false;
+    discarding = false;
+}
+
+void CertaboParser::endValue() {
+    if (inValue && !discarding) {
+        values[valueCount++] = static_cast<uint8_t>(currentValue);
+        if (!pieceRecognition && valueCount > OCCUPANCY_FRAME_VALUES) {
+            pieceRecognition = true;
+            translator.hasPieceRecognition(true);
+        }
+        if (pieceRecognition && valueCount == PIECE_FRAME_VALUES) {
+            emitPieceFrame();
+        }
     }
-    if (pieceRecognition) {
-        return parseWithPieceInfo(split_input);
-    } else {
-        return parseWithoutPieceInfo(split_input);
+    currentValue = 0;
+    inValue = false;
+}
+
+void CertaboParser::endFrame() {
+    endValue();
+    if (!discarding && !pieceRecognition && valueCount >= OCCUPANCY_FRAME_VALUES) {
+        emitOccupancyFrame();
     }
+    startFrame();
 }
 
-bool CertaboParser::parseWithPieceInfo(std::vector<std::string>& splitInput) {
-    if (splitInput.size() >= 320) {
-        std::vector<CertaboPiece> board;
-        for (int square = 0; square < 64; square++) {
-            std::array<uint8_t, 5> piece_id{0, 0, 0, 0, 0};
-            for (int i = 0; i < 5; i++) {
-                std::basic_string<char>& str = splitInput.at(square * 5 + i);
-                errno = 0;
-                char* p_end{};
-                const char* p = str.c_str();
-                const long value = std::strtol(p, &p_end, 10);
-                if ((p && *p_end != 0) || p == p_end || errno == ERANGE) {
-                    buffer.clear();
-                    return false;
-                } else {
-                    piece_id[i] = value; // std::stoi(str); -- no error checking with stoi
-                }
-            }
-            CertaboPiece piece(piece_id);
-            board.push_back(piece);
+void CertaboParser::emitPieceFrame() {
+    CertaboBoard board;
+    for (size_t square = 0; square < board.size(); square++) {
+        PieceId pieceId;
+        for (size_t i = 0; i < pieceId.size(); i++) {
+            pieceId[i] = values[square * pieceId.size() + i];
         }
-        translator.translate(board);
-        buffer.clear();
-        return true;
-    } else {
-        return false;
+        board[square] = CertaboPiece(pieceId);
     }
+    discarding = true;
+    Profiler::mark(ProfileStage::PARSED);
+    translator.translate(board);
 }
 
-bool CertaboParser::parseWithoutPieceInfo(std::vector<std::string>& splitInput) {
-    if (splitInput.size() >= 8) {
-        std::array<bool, 64> board{};
-        for (int i = 0, row = 0; row < 8; row++) {
-            std::basic_string<char>& str = splitInput.at(row);
-            errno = 0;
-            char* p_end{};
-            const char* p = str.c_str();
-            const long value = std::strtol(p, &p_end, 10);
-            if ((p && *p_end != 0) || p == p_end || errno == ERANGE) {
-                buffer.clear();
-                return false;
-            } else {
-                uint8_t b = value; // std::stoi(str); -- no error checking with stoi
-                for (int col = 7; col > -1; col--) {
-                    if ((b & (1 << col)) != 0) {
-                        board[i] = true; // occupied
-                    }
-                    i++;
-                }
-            }
-        }
-        translator.translateOccupiedSquares(board);
-        buffer.clear();
-        return true;
-    } else {
-        return false;
+void CertaboParser::emitOccupancyFrame() {
+    // the most significant bit of a row byte is the leftmost square of the row
+    chess::Bitboard occupied = 0;
+    for (int row = 0; row < 8; row++) {
+        occupied |= static_cast<chess::Bitboard>(chess::reverseBits(values[row])) << (row * 8);
     }
+    discarding = true;
+    Profiler::mark(ProfileStage::PARSED);
+    translator.translateOccupiedSquares(occupied);
 }
@@ -1,8 +1,8 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
-#include <functional>
-#include <vector>
 
 #include "BoardTranslator.h"
 
@@ -10,6 +10,11 @@ namespace eboard {
 
 /**
  * CertaboParser parses board messages from Certabo and calls a translator with the raw piece information.
+ *
+ * The parser is a streaming state machine: bytes are consumed one at a time and numbers are decoded in place into a
+ * fixed-size frame, so data may be split at any position and no heap memory is used. A frame starts with ':' or after
+ * the previous "\r\n" terminator. A board with piece recognition is emitted as soon as its 320th value is complete,
+ * a board without piece recognition when the terminator arrives.
  */
 class CertaboParser {
 
@@ -18,32 +23,27 @@ class CertaboParser {
     void parse(const uint8_t* data, size_t data_len);
 
   private:
-    template <typename T> std::vector<T> strSplit(const T& str, const T& delimiters) {
-        std::vector<T> v;
-        typename T::size_type start = 0;
-        auto pos = str.find_first_of(delimiters, start);
-        while (pos != T::npos) {
-            if (pos != start) { // ignore empty tokens
-                v.emplace_back(str, start, pos - start);
-            }
-            start = pos + 1;
-            pos = str.find_first_of(delimiters, start);
-        }
-        if (start < str.length()) {                           // ignore trailing delimiter
-            v.emplace_back(str, start, str.length() - start); // add what's left of the string
-        }
-        return v;
-    }
-
-    bool parsePart(std::string & part);
-    bool parseWithPieceInfo(std::vector<std::string> &splitInput);
-    bool parseWithoutPieceInfo(std::vector<std::string> &splitInput);
+    /** Five ID bytes for each of the 64 squares. */
+    static size_t const PIECE_FRAME_VALUES = 320;
+    /** One occupancy byte for each row. */
+    static size_t const OCCUPANCY_FRAME_VALUES = 8;
+
+    void consume(uint8_t c);
+    void startFrame();
+    void endValue();
+    void endFrame();
+    void emitPieceFrame();
+    void emitOccupancyFrame();
 
     BoardTranslator& translator;
-    std::vector<uint8_t> buffer;
-    std::vector<uint8_t> lastBoard;
-    bool reversed = false;
+    std::array<uint8_t, PIECE_FRAME_VALUES> values{};
+    size_t valueCount = 0;
+    uint16_t currentValue = 0;
+    bool inValue = false;
+    /** set when the current frame is invalid or already emitted, cleared with the next frame */
+    bool discarding = false;
+    bool carriageReturn = false;
     bool pieceRecognition = false;
 };
 
-} // namespace eboard
\ No newline at end of file
+} // namespace eboard
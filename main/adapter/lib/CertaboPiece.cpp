@@ -2,8 +2,16 @@
 
 using eboard::CertaboPiece;
 
-CertaboPiece::CertaboPiece(eboard::PieceId const &pieceId) : pieceId(pieceId) {}
+CertaboPiece::CertaboPiece(eboard::PieceId const& pieceId) {
+    for (uint8_t b : pieceId) {
+        key = (key << 8) | b;
+    }
+}
 
-eboard::PieceId& CertaboPiece::getId() {
+eboard::PieceId CertaboPiece::getId() const {
+    PieceId pieceId;
+    for (int i = 0; i < 5; i++) {
+        pieceId[i] = (key >> (8 * (4 - i))) & 0xff;
+    }
     return pieceId;
 }
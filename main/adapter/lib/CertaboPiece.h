@@ -1,7 +1,7 @@
 #pragma once
 
 #include <array>
-#include <string>
+#include <cstdint>
 
 namespace eboard {
 
@@ -9,27 +9,38 @@ using PieceId = std::array<uint8_t, 5>;
 
 /**
  * CertaboPiece represents raw piece data from a Certabo position for one piece.
+ * The five ID bytes are packed into the lower 40 bits of an integer key, the first byte being the most significant.
  */
 class CertaboPiece {
   public:
+    CertaboPiece() = default;
     explicit CertaboPiece(std::array<uint8_t, 5> const& pieceId);
 
-    PieceId& getId();
+    PieceId getId() const;
+
+    uint64_t getKey() const {
+        return key;
+    }
 
     friend bool operator<(CertaboPiece const& c1, CertaboPiece const& c2) {
-        std::string c1id;
-        for (int i = 0; i < 5; i++) {
-            c1id += std::to_string(c1.pieceId[i]) + " ";
-        }
-        std::string c2id;
-        for (int i = 0; i < 5; i++) {
-            c2id += std::to_string(c2.pieceId[i]) + " ";
-        }
-        return c1id < c2id;
+        return c1.key < c2.key;
+    }
+
+    friend bool operator==(CertaboPiece const& c1, CertaboPiece const& c2) {
+        return c1.key == c2.key;
+    }
+
+    friend bool operator!=(CertaboPiece const& c1, CertaboPiece const& c2) {
+        return c1.key != c2.key;
     }
 
   private:
-    PieceId pieceId;
+    uint64_t key = 0;
 };
 
-} // namespace eboard
\ No newline at end of file
+/**
+ * Raw piece information of all 64 squares as sent by the board.
+ */
+using CertaboBoard = std::array<CertaboPiece, 64>;
+
+} // namespace eboard
@@ -50,8 +50,50 @@ std::map<const char, const uint8_t> const Chess0x88::CHAR_PIECES{
     {'p', p}, {'n', n}, {'b', b}, {'r', r}, {'q', q}, {'k', k},
 };
 
+namespace {
+
+/** Random keys for Zobrist hashing, the keys of empty squares are 0 */
+struct ZobristKeys {
+    uint64_t pieces[13][64];
+    uint64_t castle[16];
+    uint64_t enpassant[8];
+    uint64_t side;
+};
+
+// splitmix64, see https://prng.di.unimi.it/splitmix64.c
+constexpr uint64_t nextKey(uint64_t& state) {
+    state += 0x9E3779B97F4A7C15ULL;
+    uint64_t z = state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+constexpr ZobristKeys zobristKeys() {
+    ZobristKeys result{};
+    uint64_t state = 0x636572326E7574ULL;
+    for (int piece = P; piece <= k; piece++) {
+        for (int square = 0; square < 64; square++) {
+            result.pieces[piece][square] = nextKey(state);
+        }
+    }
+    for (uint64_t& key : result.castle) {
+        key = nextKey(state);
+    }
+    for (uint64_t& key : result.enpassant) {
+        key = nextKey(state);
+    }
+    result.side = nextKey(state);
+    return result;
+}
+
+constexpr ZobristKeys ZOBRIST = zobristKeys();
+
+} // namespace
+
 Chess0x88::Chess0x88() : board{START_POSITION} {
-    moves.reserve(500);
+    history.reserve(500);
+    init_hash();
 }
 
 void Chess0x88::reset_board() {
@@ -71,7 +113,7 @@ void Chess0x88::reset_board() {
     sideToMove = -1;
     castle = 0;
     enpassant = no_sq;
-    moves.clear();
+    init_hash();
 }
 
 void Chess0x88::parse_fen(const char* fen) {
@@ -123,8 +165,8 @@ void Chess0x88::parse_fen(const char* fen) {
     // go to castling rights parsing
     fen += 2;
 
-    // parse castling rights
-    while (*fen != ' ') {
+    // parse castling rights, the remaining fields are optional
+    while (*fen && *fen != ' ') {
         switch (*fen) {
         case 'K':
             castle |= KC;
@@ -145,9 +187,10 @@ void Chess0x88::parse_fen(const char* fen) {
         fen++;
     }
     // got to en passant square
-    fen++;
+    if (*fen)
+        fen++;
     // parse en passant square
-    if (*fen != '-') {
+    if (*fen && *fen != '-') {
         // parse en passant square's file & rank
         int file = fen[0] - 'a';
         int rank = 8 - (fen[1] - '0');
@@ -156,6 +199,7 @@ void Chess0x88::parse_fen(const char* fen) {
     } else {
         enpassant = no_sq;
     }
+    init_hash();
 }
 
 int Chess0x88::is_square_attacked(int square, int side) {
@@ -260,313 +304,336 @@ int Chess0x88::is_square_attacked(int square, int side) {
 }
 
 // move generator
-std::vector<uint32_t> Chess0x88::generate_moves() {
-    std::vector<uint32_t> move_list;
+MoveList Chess0x88::generate_moves() {
+    MoveList move_list;
 
     // loop over all board squares
     for (int square = 0; square < board.size(); square++) {
         // check if the square is on board
         if (!(square & 0x88)) {
-            // white pawn and castling moves
-            if (!sideToMove) {
-                // white pawn moves
-                if (board[square] == P) {
-                    // init target square
-                    int to_square = square - 16;
-
-                    // quite white pawn moves (check if target square is on board)
-                    if (!(to_square & 0x88) && !board[to_square]) {
-                        // pawn promotions
-                        if (square >= a7 && square <= h7) {
-                            move_list.push_back(encode_move(square, to_square, Q, 0, 0, 0, castle, enpassant));
-                            move_list.push_back(encode_move(square, to_square, R, 0, 0, 0, castle, enpassant));
-                            move_list.push_back(encode_move(square, to_square, B, 0, 0, 0, castle, enpassant));
-                            move_list.push_back(encode_move(square, to_square, N, 0, 0, 0, castle, enpassant));
-                        }
-
-                        else {
-                            // one square ahead pawn move
-                            move_list.push_back(encode_move(square, to_square, 0, 0, 0, 0, castle, enpassant));
-
-                            // two squares ahead pawn move
-                            if ((square >= a2 && square <= h2) && !board[square - 32])
-                                move_list.push_back(encode_move(square, (square - 32), 0, 0, 1, 0, castle, enpassant));
-                        }
-                    }
+            generate_square_moves(square, move_list);
+        }
+    }
+    return move_list;
+}
 
-                    // white pawn capture moves
-                    for (int pawn_offset : bishop_offsets) {
-                        // white pawn offsets
-                        if (pawn_offset < 0) {
-                            // init target square
-                            int to_square = square + pawn_offset;
-
-                            // check if target square is on board
-                            if (!(to_square & 0x88)) {
-                                // capture pawn promotion
-                                if ((square >= a7 && square <= h7) &&
-                                    (board[to_square] >= 7 && board[to_square] <= 12)) {
-                                    move_list.push_back(
-                                        encode_move(square, to_square, Q, board[to_square], 0, 0, castle, enpassant));
-                                    move_list.push_back(
-                                        encode_move(square, to_square, R, board[to_square], 0, 0, castle, enpassant));
-                                    move_list.push_back(
-                                        encode_move(square, to_square, B, board[to_square], 0, 0, castle, enpassant));
-                                    move_list.push_back(
-                                        encode_move(square, to_square, N, board[to_square], 0, 0, castle, enpassant));
-                                }
-
-                                else {
-                                    // casual capture
-                                    if (board[to_square] >= 7 && board[to_square] <= 12)
-                                        move_list.push_back(encode_move(square, to_square, 0, board[to_square], 0, 0,
-                                                                        castle, enpassant));
-
-                                    // enpassant capture
-                                    if (to_square == enpassant)
-                                        move_list.push_back(
-                                            encode_move(square, to_square, 0, 7, 0, 1, castle, enpassant));
-                                }
-                            }
-                        }
-                    }
+// generate the pseudo legal moves of the piece on a square
+void Chess0x88::generate_square_moves(int square, MoveList& move_list) {
+    // white pawn and castling moves
+    if (!sideToMove) {
+        // white pawn moves
+        if (board[square] == P) {
+            // init target square
+            int to_square = square - 16;
+
+            // quite white pawn moves (check if target square is on board)
+            if (!(to_square & 0x88) && !board[to_square]) {
+                // pawn promotions
+                if (square >= a7 && square <= h7) {
+                    move_list.push_back(encode_move(square, to_square, Q, 0, 0, 0));
+                    move_list.push_back(encode_move(square, to_square, R, 0, 0, 0));
+                    move_list.push_back(encode_move(square, to_square, B, 0, 0, 0));
+                    move_list.push_back(encode_move(square, to_square, N, 0, 0, 0));
                 }
 
-                // white king castling
-                if (board[square] == K) {
-                    // if king side castling is available
-                    if (castle & KC) {
-                        // make sure there are empty squares between king & rook
-                        if (!board[f1] && !board[g1]) {
-                            // make sure king & next square are not under attack
-                            if (!is_square_attacked(e1, black) && !is_square_attacked(f1, black))
-                                move_list.push_back(encode_move(e1, g1, 0, 0, 0, 0, castle, enpassant));
-                        }
-                    }
+                else {
+                    // one square ahead pawn move
+                    move_list.push_back(encode_move(square, to_square, 0, 0, 0, 0));
 
-                    // if queen side castling is available
-                    if (castle & QC) {
-                        // make sure there are empty squares between king & rook
-                        if (!board[d1] && !board[b1] && !board[c1]) {
-                            // make sure king & next square are not under attack
-                            if (!is_square_attacked(e1, black) && !is_square_attacked(d1, black))
-                                move_list.push_back(encode_move(e1, c1, 0, 0, 0, 0, castle, enpassant));
-                        }
-                    }
+                    // two squares ahead pawn move
+                    if ((square >= a2 && square <= h2) && !board[square - 32])
+                        move_list.push_back(encode_move(square, (square - 32), 0, 0, 1, 0));
                 }
             }
 
-            // black pawn and castling moves
-            else {
-                // black pawn moves
-                if (board[square] == p) {
+            // white pawn capture moves
+            for (int pawn_offset : bishop_offsets) {
+                // white pawn offsets
+                if (pawn_offset < 0) {
                     // init target square
-                    int to_square = square + 16;
-
-                    // quite black pawn moves (check if target square is on board)
-                    if (!(to_square & 0x88) && !board[to_square]) {
-                        // pawn promotions
-                        if (square >= a2 && square <= h2) {
-                            move_list.push_back(encode_move(square, to_square, q, 0, 0, 0, castle, enpassant));
-                            move_list.push_back(encode_move(square, to_square, r, 0, 0, 0, castle, enpassant));
-                            move_list.push_back(encode_move(square, to_square, b, 0, 0, 0, castle, enpassant));
-                            move_list.push_back(encode_move(square, to_square, n, 0, 0, 0, castle, enpassant));
-                        }
-
-                        else {
-                            // one square ahead pawn move
-                            move_list.push_back(encode_move(square, to_square, 0, 0, 0, 0, castle, enpassant));
+                    int to_square = square + pawn_offset;
 
-                            // two squares ahead pawn move
-                            if ((square >= a7 && square <= h7) && !board[square + 32])
-                                move_list.push_back(encode_move(square, (square + 32), 0, 0, 1, 0, castle, enpassant));
+                    // check if target square is on board
+                    if (!(to_square & 0x88)) {
+                        // capture pawn promotion
+                        if ((square >= a7 && square <= h7) &&
+                            (board[to_square] >= 7 && board[to_square] <= 12)) {
+                            move_list.push_back(
+                                encode_move(square, to_square, Q, board[to_square], 0, 0));
+                            move_list.push_back(
+                                encode_move(square, to_square, R, board[to_square], 0, 0));
+                            move_list.push_back(
+                                encode_move(square, to_square, B, board[to_square], 0, 0));
+                            move_list.push_back(
+                                encode_move(square, to_square, N, board[to_square], 0, 0));
                         }
-                    }
 
-                    // black pawn capture moves
-                    for (int pawn_offset : bishop_offsets) {
-                        // white pawn offsets
-                        if (pawn_offset > 0) {
-                            // init target square
-                            int to_square = square + pawn_offset;
-
-                            // check if target square is on board
-                            if (!(to_square & 0x88)) {
-                                // capture pawn promotion
-                                if ((square >= a2 && square <= h2) &&
-                                    (board[to_square] >= 1 && board[to_square] <= 6)) {
-                                    move_list.push_back(
-                                        encode_move(square, to_square, q, board[to_square], 0, 0, castle, enpassant));
-                                    move_list.push_back(
-                                        encode_move(square, to_square, r, board[to_square], 0, 0, castle, enpassant));
-                                    move_list.push_back(
-                                        encode_move(square, to_square, b, board[to_square], 0, 0, castle, enpassant));
-                                    move_list.push_back(
-                                        encode_move(square, to_square, n, board[to_square], 0, 0, castle, enpassant));
-                                }
-
-                                else {
-                                    // casual capture
-                                    if (board[to_square] >= 1 && board[to_square] <= 6)
-                                        move_list.push_back(encode_move(square, to_square, 0, board[to_square], 0, 0,
-                                                                        castle, enpassant));
-
-                                    // en passant capture
-                                    if (to_square == enpassant)
-                                        move_list.push_back(
-                                            encode_move(square, to_square, 0, 1, 0, 1, castle, enpassant));
-                                }
-                            }
+                        else {
+                            // casual capture
+                            if (board[to_square] >= 7 && board[to_square] <= 12)
+                                move_list.push_back(encode_move(square, to_square, 0, board[to_square], 0, 0));
+
+                            // enpassant capture
+                            if (to_square == enpassant)
+                                move_list.push_back(
+                                    encode_move(square, to_square, 0, 7, 0, 1));
                         }
                     }
                 }
+            }
+        }
 
-                // black king castling
-                if (board[square] == k) {
-                    // if king side castling is available
-                    if (castle & kc) {
-                        // make sure there are empty squares between king & rook
-                        if (!board[f8] && !board[g8]) {
-                            // make sure king & next square are not under attack
-                            if (!is_square_attacked(e8, white) && !is_square_attacked(f8, white))
-                                move_list.push_back(encode_move(e8, g8, 0, 0, 0, 0, castle, enpassant));
-                        }
-                    }
+        // white king castling
+        if (board[square] == K) {
+            // if king side castling is available
+            if (castle & KC) {
+                // make sure there are empty squares between king & rook
+                if (!board[f1] && !board[g1]) {
+                    // make sure king & next square are not under attack
+                    if (!is_square_attacked(e1, black) && !is_square_attacked(f1, black))
+                        move_list.push_back(encode_move(e1, g1, 0, 0, 0, 0));
+                }
+            }
 
-                    // if queen side castling is available
-                    if (castle & qc) {
-                        // make sure there are empty squares between king & rook
-                        if (!board[d8] && !board[b8] && !board[c8]) {
-                            // make sure king & next square are not under attack
-                            if (!is_square_attacked(e8, white) && !is_square_attacked(d8, white))
-                                move_list.push_back(encode_move(e8, c8, 0, 0, 0, 0, castle, enpassant));
-                        }
-                    }
+            // if queen side castling is available
+            if (castle & QC) {
+                // make sure there are empty squares between king & rook
+                if (!board[d1] && !board[b1] && !board[c1]) {
+                    // make sure king & next square are not under attack
+                    if (!is_square_attacked(e1, black) && !is_square_attacked(d1, black))
+                        move_list.push_back(encode_move(e1, c1, 0, 0, 0, 0));
                 }
             }
+        }
+    }
 
-            // knight moves
-            if (!sideToMove ? board[square] == N : board[square] == n) {
-                // loop over knight move offsets
-                for (int knight_offset : knight_offsets) {
-                    // init target square
-                    int to_square = square + knight_offset;
+    // black pawn and castling moves
+    else {
+        // black pawn moves
+        if (board[square] == p) {
+            // init target square
+            int to_square = square + 16;
+
+            // quite black pawn moves (check if target square is on board)
+            if (!(to_square & 0x88) && !board[to_square]) {
+                // pawn promotions
+                if (square >= a2 && square <= h2) {
+                    move_list.push_back(encode_move(square, to_square, q, 0, 0, 0));
+                    move_list.push_back(encode_move(square, to_square, r, 0, 0, 0));
+                    move_list.push_back(encode_move(square, to_square, b, 0, 0, 0));
+                    move_list.push_back(encode_move(square, to_square, n, 0, 0, 0));
+                }
 
-                    // init target piece
-                    int piece = board[to_square];
+                else {
+                    // one square ahead pawn move
+                    move_list.push_back(encode_move(square, to_square, 0, 0, 0, 0));
 
-                    // make sure target square is onboard
-                    if (!(to_square & 0x88)) {
-                        //
-                        if (!sideToMove ? (!piece || (piece >= 7 && piece <= 12))
-                                        : (!piece || (piece >= 1 && piece <= 6))) {
-                            // on capture
-                            if (piece)
-                                move_list.push_back(encode_move(square, to_square, 0, piece, 0, 0, castle, enpassant));
-
-                            // on empty square
-                            else
-                                move_list.push_back(encode_move(square, to_square, 0, 0, 0, 0, castle, enpassant));
-                        }
-                    }
+                    // two squares ahead pawn move
+                    if ((square >= a7 && square <= h7) && !board[square + 32])
+                        move_list.push_back(encode_move(square, (square + 32), 0, 0, 1, 0));
                 }
             }
 
-            // king moves
-            if (!sideToMove ? board[square] == K : board[square] == k) {
-                // loop over king move offsets
-                for (int king_offset : king_offsets) {
+            // black pawn capture moves
+            for (int pawn_offset : bishop_offsets) {
+                // white pawn offsets
+                if (pawn_offset > 0) {
                     // init target square
-                    int to_square = square + king_offset;
+                    int to_square = square + pawn_offset;
 
-                    // init target piece
-                    int piece = board[to_square];
-
-                    // make sure target square is onboard
+                    // check if target square is on board
                     if (!(to_square & 0x88)) {
-                        //
-                        if (!sideToMove ? (!piece || (piece >= 7 && piece <= 12))
-                                        : (!piece || (piece >= 1 && piece <= 6))) {
-                            // on capture
-                            if (piece)
-                                move_list.push_back(encode_move(square, to_square, 0, piece, 0, 0, castle, enpassant));
-
-                            // on empty square
-                            else
-                                move_list.push_back(encode_move(square, to_square, 0, 0, 0, 0, castle, enpassant));
+                        // capture pawn promotion
+                        if ((square >= a2 && square <= h2) &&
+                            (board[to_square] >= 1 && board[to_square] <= 6)) {
+                            move_list.push_back(
+                                encode_move(square, to_square, q, board[to_square], 0, 0));
+                            move_list.push_back(
+                                encode_move(square, to_square, r, board[to_square], 0, 0));
+                            move_list.push_back(
+                                encode_move(square, to_square, b, board[to_square], 0, 0));
+                            move_list.push_back(
+                                encode_move(square, to_square, n, board[to_square], 0, 0));
+                        }
+
+                        else {
+                            // casual capture
+                            if (board[to_square] >= 1 && board[to_square] <= 6)
+                                move_list.push_back(encode_move(square, to_square, 0, board[to_square], 0, 0));
+
+                            // en passant capture
+                            if (to_square == enpassant)
+                                move_list.push_back(
+                                    encode_move(square, to_square, 0, 1, 0, 1));
                         }
                     }
                 }
             }
+        }
 
-            // bishop & queen moves
-            if (!sideToMove ? (board[square] == B) || (board[square] == Q)
-                            : (board[square] == b) || (board[square] == q)) {
-                // loop over bishop & queen offsets
-                for (int bishop_offset : bishop_offsets) {
-                    // init target square
-                    int to_square = square + bishop_offset;
-
-                    // loop over attack ray
-                    while (!(to_square & 0x88)) {
-                        // init target piece
-                        int piece = board[to_square];
-
-                        // if hits own piece
-                        if (!sideToMove ? (piece >= 1 && piece <= 6) : ((piece >= 7 && piece <= 12)))
-                            break;
+        // black king castling
+        if (board[square] == k) {
+            // if king side castling is available
+            if (castle & kc) {
+                // make sure there are empty squares between king & rook
+                if (!board[f8] && !board[g8]) {
+                    // make sure king & next square are not under attack
+                    if (!is_square_attacked(e8, white) && !is_square_attacked(f8, white))
+                        move_list.push_back(encode_move(e8, g8, 0, 0, 0, 0));
+                }
+            }
 
-                        // if hits opponent's piece
-                        if (!sideToMove ? (piece >= 7 && piece <= 12) : ((piece >= 1 && piece <= 6))) {
-                            move_list.push_back(encode_move(square, to_square, 0, piece, 0, 0, castle, enpassant));
-                            break;
-                        }
+            // if queen side castling is available
+            if (castle & qc) {
+                // make sure there are empty squares between king & rook
+                if (!board[d8] && !board[b8] && !board[c8]) {
+                    // make sure king & next square are not under attack
+                    if (!is_square_attacked(e8, white) && !is_square_attacked(d8, white))
+                        move_list.push_back(encode_move(e8, c8, 0, 0, 0, 0));
+                }
+            }
+        }
+    }
 
-                        // if steps into an empty square
-                        if (!piece)
-                            move_list.push_back(encode_move(square, to_square, 0, 0, 0, 0, castle, enpassant));
+    // knight moves
+    if (!sideToMove ? board[square] == N : board[square] == n) {
+        // loop over knight move offsets
+        for (int knight_offset : knight_offsets) {
+            // init target square
+            int to_square = square + knight_offset;
+
+            // init target piece
+            int piece = board[to_square];
+
+            // make sure target square is onboard
+            if (!(to_square & 0x88)) {
+                //
+                if (!sideToMove ? (!piece || (piece >= 7 && piece <= 12))
+                                : (!piece || (piece >= 1 && piece <= 6))) {
+                    // on capture
+                    if (piece)
+                        move_list.push_back(encode_move(square, to_square, 0, piece, 0, 0));
+
+                    // on empty square
+                    else
+                        move_list.push_back(encode_move(square, to_square, 0, 0, 0, 0));
+                }
+            }
+        }
+    }
 
-                        // increment target square
-                        to_square += bishop_offset;
-                    }
+    // king moves
+    if (!sideToMove ? board[square] == K : board[square] == k) {
+        // loop over king move offsets
+        for (int king_offset : king_offsets) {
+            // init target square
+            int to_square = square + king_offset;
+
+            // init target piece
+            int piece = board[to_square];
+
+            // make sure target square is onboard
+            if (!(to_square & 0x88)) {
+                //
+                if (!sideToMove ? (!piece || (piece >= 7 && piece <= 12))
+                                : (!piece || (piece >= 1 && piece <= 6))) {
+                    // on capture
+                    if (piece)
+                        move_list.push_back(encode_move(square, to_square, 0, piece, 0, 0));
+
+                    // on empty square
+                    else
+                        move_list.push_back(encode_move(square, to_square, 0, 0, 0, 0));
                 }
             }
+        }
+    }
 
-            // rook & queen moves
-            if (!sideToMove ? (board[square] == R) || (board[square] == Q)
-                            : (board[square] == r) || (board[square] == q)) {
-                // loop over bishop & queen offsets
-                for (int rook_offset : rook_offsets) {
-                    // init target square
-                    int to_square = square + rook_offset;
+    // bishop & queen moves
+    if (!sideToMove ? (board[square] == B) || (board[square] == Q)
+                    : (board[square] == b) || (board[square] == q)) {
+        // loop over bishop & queen offsets
+        for (int bishop_offset : bishop_offsets) {
+            // init target square
+            int to_square = square + bishop_offset;
+
+            // loop over attack ray
+            while (!(to_square & 0x88)) {
+                // init target piece
+                int piece = board[to_square];
+
+                // if hits own piece
+                if (!sideToMove ? (piece >= 1 && piece <= 6) : ((piece >= 7 && piece <= 12)))
+                    break;
+
+                // if hits opponent's piece
+                if (!sideToMove ? (piece >= 7 && piece <= 12) : ((piece >= 1 && piece <= 6))) {
+                    move_list.push_back(encode_move(square, to_square, 0, piece, 0, 0));
+                    break;
+                }
 
-                    // loop over attack ray
-                    while (!(to_square & 0x88)) {
-                        // init target piece
-                        int piece = board[to_square];
+                // if steps into an empty square
+                if (!piece)
+                    move_list.push_back(encode_move(square, to_square, 0, 0, 0, 0));
 
-                        // if hits own piece
-                        if (!sideToMove ? (piece >= 1 && piece <= 6) : ((piece >= 7 && piece <= 12)))
-                            break;
+                // increment target square
+                to_square += bishop_offset;
+            }
+        }
+    }
 
-                        // if hits opponent's piece
-                        if (!sideToMove ? (piece >= 7 && piece <= 12) : ((piece >= 1 && piece <= 6))) {
-                            move_list.push_back(encode_move(square, to_square, 0, piece, 0, 0, castle, enpassant));
-                            break;
-                        }
+    // rook & queen moves
+    if (!sideToMove ? (board[square] == R) || (board[square] == Q)
+                    : (board[square] == r) || (board[square] == q)) {
+        // loop over bishop & queen offsets
+        for (int rook_offset : rook_offsets) {
+            // init target square
+            int to_square = square + rook_offset;
+
+            // loop over attack ray
+            while (!(to_square & 0x88)) {
+                // init target piece
+                int piece = board[to_square];
+
+                // if hits own piece
+                if (!sideToMove ? (piece >= 1 && piece <= 6) : ((piece >= 7 && piece <= 12)))
+                    break;
+
+                // if hits opponent's piece
+                if (!sideToMove ? (piece >= 7 && piece <= 12) : ((piece >= 1 && piece <= 6))) {
+                    move_list.push_back(encode_move(square, to_square, 0, piece, 0, 0));
+                    break;
+                }
 
-                        // if steps into an empty square
-                        if (!piece)
-                            move_list.push_back(encode_move(square, to_square, 0, 0, 0, 0, castle, enpassant));
+                // if steps into an empty square
+                if (!piece)
+                    move_list.push_back(encode_move(square, to_square, 0, 0, 0, 0));
 
-                        // increment target square
-                        to_square += rook_offset;
-                    }
-                }
+                // increment target square
+                to_square += rook_offset;
             }
         }
     }
-    return move_list;
+}
+
+uint32_t Chess0x88::find_move(int from_square_64, int to_square_64, int promoted_piece) {
+    MoveList move_list;
+    generate_square_moves((from_square_64 / 8) * 16 + (from_square_64 & 7), move_list);
+    for (uint32_t move : move_list) {
+        if (static_cast<int>(get_move_target_64(move)) != to_square_64) {
+            continue;
+        }
+        if (get_move_piece(move) && static_cast<int>(get_move_piece(move)) != promoted_piece) {
+            continue;
+        }
+        // legality check: the own king must not be attacked after the move
+        if (make_move(move)) {
+            pop();
+            unmake_move(move);
+            return move;
+        }
+    }
+    return 0;
 }
 
 bool Chess0x88::make_move(uint32_t move) {
@@ -576,6 +643,7 @@ bool Chess0x88::make_move(uint32_t move) {
     int promoted_piece = get_move_piece(move);
     int enpass = get_move_enpassant(move);
     int double_push = get_move_pawn(move);
+    HistoryEntry previous{move, hash, occupancy, enpassant, castle, -1};
     bool castling = false;
     if ((board[from_square] == K || board[from_square] == k) &&
         ((from_square == e1 && (to_square == g1 || to_square == c1)) ||
@@ -583,17 +651,19 @@ bool Chess0x88::make_move(uint32_t move) {
         castling = true;
     }
 
+    hash ^= state_hash();
+
     // move piece
-    board[to_square] = board[from_square];
-    board[from_square] = e;
+    set_square(to_square, board[from_square]);
+    set_square(from_square, e);
 
     // pawn promotion
     if (promoted_piece)
-        board[to_square] = promoted_piece;
+        set_square(to_square, promoted_piece);
 
     // enpassant capture
     if (enpass)
-        !sideToMove ? (board[to_square + 16] = e) : (board[to_square - 16] = e);
+        set_square(!sideToMove ? to_square + 16 : to_square - 16, e);
 
     // reset enpassant square
     enpassant = no_sq;
@@ -608,26 +678,26 @@ bool Chess0x88::make_move(uint32_t move) {
         switch (to_square) {
         // white castles king side
         case g1:
-            board[f1] = board[h1];
-            board[h1] = e;
+            set_square(f1, board[h1]);
+            set_square(h1, e);
             break;
 
         // white castles queen side
         case c1:
-            board[d1] = board[a1];
-            board[a1] = e;
+            set_square(d1, board[a1]);
+            set_square(a1, e);
             break;
 
             // black castles king side
         case g8:
-            board[f8] = board[h8];
-            board[h8] = e;
+            set_square(f8, board[h8]);
+            set_square(h8, e);
             break;
 
             // black castles queen side
         case c8:
-            board[d8] = board[a8];
-            board[a8] = e;
+            set_square(d8, board[a8]);
+            set_square(a8, e);
             break;
         default:
             break;
@@ -644,14 +714,16 @@ bool Chess0x88::make_move(uint32_t move) {
 
     // change side
     sideToMove ^= 1;
+    hash ^= state_hash();
+
+    push_history(previous);
 
     // take move back if king is under check
     if (is_square_attacked(king_square[sideToMove ^ 1], sideToMove)) {
-        unmake_move(move);
+        unmake_move(pop());
         // illegal move
         return false;
     } else {
-        moves.push_back(move);
         // legal move
         return true;
     }
@@ -663,29 +735,27 @@ void Chess0x88::unmake_move(uint32_t move) {
     int promoted_piece = get_move_piece(move);
     int captured_piece = get_move_capture(move);
     int enpass = get_move_enpassant(move);
-    int ep_square = get_move_epsquare(move);
 
+    hash ^= state_hash();
     sideToMove ^= 1;
 
     if (promoted_piece) {
-        board[from_square] = sideToMove == white ? P : p;
+        set_square(from_square, sideToMove == white ? P : p);
     } else {
-        board[from_square] = board[to_square];
+        set_square(from_square, board[to_square]);
     }
 
     if (captured_piece) {
         if (enpass) {
-            !sideToMove ? (board[to_square + 16] = captured_piece) : (board[to_square - 16] = captured_piece);
-            board[to_square] = e;
+            set_square(!sideToMove ? to_square + 16 : to_square - 16, captured_piece);
+            set_square(to_square, e);
         } else {
-            board[to_square] = captured_piece;
+            set_square(to_square, captured_piece);
         }
     } else {
-        board[to_square] = e;
+        set_square(to_square, e);
     }
 
-    enpassant = ep_square;
-
     bool castling = false;
     if ((board[from_square] == K || board[from_square] == k) &&
         ((from_square == e1 && (to_square == g1 || to_square == c1)) ||
@@ -695,20 +765,20 @@ void Chess0x88::unmake_move(uint32_t move) {
     if (castling) {
         switch (to_square) {
         case g1:
-            board[h1] = board[f1];
-            board[f1] = e;
+            set_square(h1, board[f1]);
+            set_square(f1, e);
             break;
         case c1:
-            board[a1] = board[d1];
-            board[d1] = e;
+            set_square(a1, board[d1]);
+            set_square(d1, e);
             break;
         case g8:
-            board[h8] = board[f8];
-            board[f8] = e;
+            set_square(h8, board[f8]);
+            set_square(f8, e);
             break;
         case c8:
-            board[a8] = board[d8];
-            board[d8] = e;
+            set_square(a8, board[d8]);
+            set_square(d8, e);
             break;
         default:
             break;
@@ -717,19 +787,44 @@ void Chess0x88::unmake_move(uint32_t move) {
     if (board[from_square] == K || board[from_square] == k) {
         king_square[sideToMove] = from_square;
     }
-    castle = get_move_castling(move);
+    // en passant square and castling rights cannot be derived from the move
+    enpassant = popped.enpassant;
+    castle = popped.castle;
+    hash ^= state_hash();
 }
 
 uint32_t Chess0x88::pop() {
-    if (!moves.empty()) {
-        uint32_t move = moves.back();
-        moves.pop_back();
-        return move;
+    if (!history.empty()) {
+        popped = history.back();
+        occupancy_heads[occupancy_bucket(popped.occupancy)] = popped.previous;
+        history.pop_back();
+        return popped.move;
     } else {
         return 0;
     }
 }
 
+int Chess0x88::findOccupancy(Bitboard occupied) const {
+    for (int index = occupancy_heads[occupancy_bucket(occupied)]; index >= 0; index = history[index].previous) {
+        if (history[index].occupancy == occupied) {
+            return static_cast<int>(history.size()) - index;
+        }
+    }
+    return 0;
+}
+
+uint64_t Chess0x88::getHash() const {
+    return hash;
+}
+
+int Chess0x88::countRepetitions() const {
+    int result = 0;
+    for (HistoryEntry const& entry : history) {
+        result += entry.hash == hash;
+    }
+    return result;
+}
+
 int Chess0x88::getSideToMove() const {
     return sideToMove;
 }
@@ -748,6 +843,10 @@ std::vector<uint8_t> Chess0x88::getOccupiedSquares() const {
     return result;
 }
 
+Bitboard Chess0x88::getOccupancy() const {
+    return occupancy;
+}
+
 uint8_t Chess0x88::getPiece(uint8_t rank, uint8_t file) const {
     uint8_t square = rank * 16 + file;
     return board[square];
@@ -779,3 +878,51 @@ uint8_t Chess0x88::getPieceColor(uint8_t square) {
 bool Chess0x88::isStartPosition() {
     return board == START_POSITION && sideToMove == white && enpassant == no_sq && castle == 15;
 }
+
+void Chess0x88::set_square(int square, int piece) {
+    int square_64 = to_64(square);
+    hash ^= ZOBRIST.pieces[board[square]][square_64] ^ ZOBRIST.pieces[piece][square_64];
+    if ((board[square] == e) != (piece == e)) {
+        occupancy ^= squareMask(square_64);
+    }
+    board[square] = piece;
+}
+
+uint64_t Chess0x88::state_hash() const {
+    uint64_t result = ZOBRIST.castle[castle & 15];
+    if (enpassant != no_sq) {
+        result ^= ZOBRIST.enpassant[enpassant & 7];
+    }
+    if (sideToMove == black) {
+        result ^= ZOBRIST.side;
+    }
+    return result;
+}
+
+void Chess0x88::init_hash() {
+    hash = 0;
+    occupancy = 0;
+    for (int rank = 0; rank < 8; rank++) {
+        for (int file = 0; file < 8; file++) {
+            uint8_t piece = board[rank * 16 + file];
+            hash ^= ZOBRIST.pieces[piece][rank * 8 + file];
+            if (piece) {
+                occupancy |= squareMask(rank * 8 + file);
+            }
+        }
+    }
+    hash ^= state_hash();
+    history.clear();
+    occupancy_heads.fill(-1);
+}
+
+void Chess0x88::push_history(HistoryEntry entry) {
+    int& head = occupancy_heads[occupancy_bucket(entry.occupancy)];
+    entry.previous = head;
+    history.push_back(entry);
+    head = static_cast<int>(history.size()) - 1;
+}
+
+size_t Chess0x88::occupancy_bucket(Bitboard occupied) {
+    return static_cast<size_t>(fibonacciHash(occupied, OCCUPANCY_BUCKET_BITS));
+}
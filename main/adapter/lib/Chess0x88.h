@@ -6,10 +6,13 @@
  */
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <map>
 #include <vector>
 
+#include "Bitboard.h"
+
 /* Move formatting
 0000 0000 0000 0000 0000 0000 0011 1111       source square
 0000 0000 0000 0000 0000 1111 1100 0000       target square
@@ -17,16 +20,13 @@
 0000 0000 0000 1111 0000 0000 0000 0000       captured piece
 0000 0000 0001 0000 0000 0000 0000 0000       double pawn flag
 0000 0000 0010 0000 0000 0000 0000 0000       en passant flag
-0000 0011 1100 0000 0000 0000 0000 0000       castle flags
-1111 1100 0000 0000 0000 0000 0000 0000       en passant square of position before move
 */
 
 #define to_64(square) ((square >> 4) * 8 + (square & 7))
 
 // encode move
-#define encode_move(source, target, piece, capture, pawn, enpassant, castling, epsquare)                               \
-    ((to_64(source)) | (to_64(target) << 6) | (piece << 12) | (capture << 16) | (pawn << 20) | (enpassant << 21) |     \
-     (castling << 22) | (to_64(epsquare) << 26))
+#define encode_move(source, target, piece, capture, pawn, enpassant)                                                   \
+    ((to_64(source)) | (to_64(target) << 6) | (piece << 12) | (capture << 16) | (pawn << 20) | (enpassant << 21))
 
 // decode move's source square
 #define get_move_source_64(move) (move & 0x3f)
@@ -48,12 +48,6 @@
 // decode move's en passant flag
 #define get_move_enpassant(move) ((move >> 21) & 0x1)
 
-// decode move's castling flag
-#define get_move_castling(move) ((move >> 22) & 0xf)
-
-// decode ep square
-#define get_move_epsquare_64(move) ((move >> 26) & 0x3f)
-#define get_move_epsquare(move) (((get_move_epsquare_64(move) / 8) * 16) + (get_move_epsquare_64(move) & 7))
 
 namespace chess {
 
@@ -86,21 +80,91 @@ static int bishop_offsets[4] = {15, 17, -15, -17};
 static int rook_offsets[4] = {16, -16, 1, -1};
 static int king_offsets[8] = {16, -16, 1, -1, 15, 17, -15, -17};
 
+/**
+ * Fixed capacity list of moves, large enough for the pseudo legal moves of any position.
+ */
+class MoveList {
+  public:
+    static size_t const CAPACITY = 256;
+
+    void push_back(uint32_t move) {
+        moves[count++] = move;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    uint32_t operator[](size_t index) const {
+        return moves[index];
+    }
+
+    uint32_t const* begin() const {
+        return moves.data();
+    }
+
+    uint32_t const* end() const {
+        return moves.data() + count;
+    }
+
+  private:
+    std::array<uint32_t, CAPACITY> moves;
+    size_t count = 0;
+};
+
 class Chess0x88 {
   public:
     Chess0x88();
 
     void reset_board();
     void parse_fen(const char* fen);
-    std::vector<uint32_t> generate_moves();
+    MoveList generate_moves();
+
+    /**
+     * Find a legal move without generating the moves of all pieces.
+     * @param from_square_64 source square, 0 is a8
+     * @param to_square_64 target square, 0 is a8
+     * @param promoted_piece piece a pawn is promoted to, only used for promotion moves
+     * @return the encoded move or 0 if there is no such legal move
+     */
+    uint32_t find_move(int from_square_64, int to_square_64, int promoted_piece);
     bool make_move(uint32_t move);
+
+    /**
+     * Take back a move, it must be the move returned by the preceding pop.
+     */
     void unmake_move(uint32_t move);
+
+    /**
+     * Remove the last move from the history.
+     * @return the move or 0 if there is none
+     */
     uint32_t pop();
 
+    /**
+     * Find the latest earlier position of the game with the given occupancy.
+     * @param occupied occupied squares, square 0 is a8
+     * @return number of moves to take back to reach that position, 0 if there is no such position
+     */
+    int findOccupancy(Bitboard occupied) const;
+
+    /** @return Zobrist hash of the position, including side to move, castling rights and en passant file */
+    uint64_t getHash() const;
+
+    /** @return how often the current position occurred earlier in the game */
+    int countRepetitions() const;
+
     int getSideToMove() const;
 
     std::vector<uint8_t> getOccupiedSquares() const;
 
+    /** @return occupied squares as bitboard, square 0 is a8 */
+    Bitboard getOccupancy() const;
+
     uint8_t getPiece(uint8_t rank, uint8_t file) const;
     uint8_t getPiece(uint8_t square);
     uint8_t getPieceColor(uint8_t square);
@@ -108,7 +172,27 @@ class Chess0x88 {
     bool isStartPosition();
 
   private:
+    /** A played move with the state of the position before it which cannot be derived from the move */
+    struct HistoryEntry {
+        uint32_t move;
+        uint64_t hash;
+        Bitboard occupancy;
+        int enpassant;
+        int castle;
+        // previous entry in the same occupancy bucket, -1 if none
+        int previous;
+    };
+
+    static unsigned const OCCUPANCY_BUCKET_BITS = 8;
+    static size_t const OCCUPANCY_BUCKETS = size_t{1} << OCCUPANCY_BUCKET_BITS;
+
     int is_square_attacked(int square, int side);
+    void generate_square_moves(int square, MoveList& move_list);
+    void set_square(int square, int piece);
+    uint64_t state_hash() const;
+    void init_hash();
+    void push_history(HistoryEntry entry);
+    static size_t occupancy_bucket(Bitboard occupied);
 
     static uint8_t castling_rights[128];
     static std::array<uint8_t, 128> const START_POSITION;
@@ -120,7 +204,14 @@ class Chess0x88 {
     int castle = 15;
     // kings' squares
     int king_square[2] = {e1, e8};
-    std::vector<uint32_t> moves;
+    // Zobrist hash and occupancy, both updated incrementally
+    uint64_t hash = 0;
+    Bitboard occupancy = 0;
+    std::vector<HistoryEntry> history;
+    // the entry removed by the last pop, unmake_move restores its en passant square and castling rights
+    HistoryEntry popped{};
+    // latest history entry per occupancy bucket, -1 if none
+    std::array<int, OCCUPANCY_BUCKETS> occupancy_heads;
 };
 
 } // namespace chess
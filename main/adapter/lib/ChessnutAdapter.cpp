@@ -90,31 +90,19 @@ ChessnutAdapter::ChessnutAdapter(ToUsbFunction toUsb, ToBleFunction toBle)
     : calibrationLeds({0xff, 0xff, 0x08, 0, 0, 0x08, 0xff, 0xff}), ledControl(std::move(toUsb)),
       toBle(std::move(toBle)), boardMessageParser(
                                    [this](std::array<eboard::StoneId, 64> const& board) {
-                                       if (board == WHITE_KING_A3) {
-                                           ledControl.setBrightness(0x30);
-                                       } else if (board == WHITE_KING_B3) {
-                                           ledControl.setBrightness(0x39);
-                                       } else if (board == WHITE_KING_C3) {
-                                           ledControl.setBrightness(0x3f);
-                                       } else if (board == WHITE_KING_D3) {
-                                           ledControl.setBrightness(0x40);
-                                       } else if (board == WHITE_KING_E3) {
-                                           ledControl.setBrightness(0x7f);
-                                       } else if (board == WHITE_KING_F3) {
-                                           ledControl.setBrightness(0x80);
-                                       } else if (board == WHITE_KING_G3) {
-                                           ledControl.setBrightness(0xb0);
-                                       } else if (board == WHITE_KING_H3) {
-                                           ledControl.setBrightness(0xfe);
+                                       Gesture const* gesture = gestures.find(board);
+                                       GestureAction action = gesture ? gesture->action : GestureAction::NONE;
+                                       if (action == GestureAction::BRIGHTNESS) {
+                                           ledControl.setBrightness(gesture->value);
                                        }
-                                       if (!initialPositionReceived && board == STANDARD_POSITION) {
+                                       if (!initialPositionReceived && action == GestureAction::INITIAL_POSITION) {
                                            initialPositionReceived = true;
                                            if (!pieceRecognition) {
                                                lightCenterLeds();
                                            }
                                        }
                                        if (initialPositionReceived) {
-                                           converter.process(board);
+                                           sendBoard(board);
                                        } else if (!pieceRecognition) {
                                            calibrationLeds = {0xff, 0xff, 0, 0, 0, 0, 0xff, 0xff};
                                            for (int square = 0; square < 64; square++) {
@@ -141,6 +129,9 @@ ChessnutAdapter::ChessnutAdapter(ToUsbFunction toUsb, ToBleFunction toBle)
           [this](eboard::Stones const& stones) {
               boardMessageParser.updateStones(stones);
               calibrationComplete = true;
+              if (calibrationStore) {
+                  calibrationStore(stones);
+              }
               lightCenterLeds();
           },
           [this](int square) {
@@ -157,15 +148,24 @@ ChessnutAdapter::ChessnutAdapter(ToUsbFunction toUsb, ToBleFunction toBle)
           [this](uint8_t* data, size_t data_len) {
               this->toBle(data, data_len, false);
           }) {
+    gestures.add(STANDARD_POSITION, GestureAction::INITIAL_POSITION);
+    gestures.add(WHITE_KING_A3, GestureAction::BRIGHTNESS, 0x30);
+    gestures.add(WHITE_KING_B3, GestureAction::BRIGHTNESS, 0x39);
+    gestures.add(WHITE_KING_C3, GestureAction::BRIGHTNESS, 0x3f);
+    gestures.add(WHITE_KING_D3, GestureAction::BRIGHTNESS, 0x40);
+    gestures.add(WHITE_KING_E3, GestureAction::BRIGHTNESS, 0x7f);
+    gestures.add(WHITE_KING_F3, GestureAction::BRIGHTNESS, 0x80);
+    gestures.add(WHITE_KING_G3, GestureAction::BRIGHTNESS, 0xb0);
+    gestures.add(WHITE_KING_H3, GestureAction::BRIGHTNESS, 0xfe);
     ledCommand(calibrationLeds);
 }
 
 void ChessnutAdapter::lightCenterLeds() {
-    std::vector<uint8_t> centerLeds{0, 0, 0, 0x18, 0x18, 0, 0, 0};
+    LedCommand centerLeds{0, 0, 0, 0x18, 0x18, 0, 0, 0};
     ledCommand(centerLeds);
 }
 
-void ChessnutAdapter::clearBitForSquare(std::vector<uint8_t>& data, int square) {
+void ChessnutAdapter::clearBitForSquare(LedCommand& data, int square) {
     int row = 7 - square / 8;
     int col = 7 - square % 8;
     int pos = (row * 8 + col);
@@ -185,14 +185,80 @@ void ChessnutAdapter::fromUsb(const uint8_t* data, size_t data_len) {
     }
 }
 
+void ChessnutAdapter::sendBoard(std::array<eboard::StoneId, 64> const& board) {
+    auto now = std::chrono::steady_clock::now();
+    auto sinceLastSent = now - lastSentTime;
+    bool keepAliveDue = keepAliveInterval.count() > 0 && sinceLastSent >= keepAliveInterval;
+    bool paced = sinceLastSent < std::chrono::microseconds(connectionIntervalMicros);
+    bool resend = resendBoard.exchange(false);
+    if (!boardSent || resend || (board != lastSentBoard && !paced) || keepAliveDue) {
+        converter.process(board);
+        lastSentBoard = board;
+        lastSentTime = now;
+        boardSent = true;
+        boardPending = false;
+    } else if (board != lastSentBoard) {
+        pendingBoard = board;
+        boardPending = true;
+    } else {
+        // the board is back to the one sent last, nothing changed for the app
+        boardPending = false;
+    }
+}
+
+int ChessnutAdapter::sendPendingBoard() {
+    if (!boardPending) {
+        return -1;
+    }
+    auto sinceLastSent = std::chrono::steady_clock::now() - lastSentTime;
+    auto remainingMicros = std::chrono::duration_cast<std::chrono::microseconds>(
+                               std::chrono::microseconds(connectionIntervalMicros) - sinceLastSent)
+                               .count();
+    if (remainingMicros > 0) {
+        return static_cast<int>((remainingMicros + 999) / 1000);
+    }
+    sendBoard(pendingBoard);
+    return -1;
+}
+
+void ChessnutAdapter::setKeepAliveInterval(int keepAliveMillis) {
+    keepAliveInterval = std::chrono::milliseconds(keepAliveMillis);
+}
+
+void ChessnutAdapter::setHistoryDepth(size_t depth) {
+    boardMessageParser.setHistoryDepth(depth);
+}
+
+void ChessnutAdapter::setDebounceSettings(DebounceSettings const& settings) {
+    boardMessageParser.setDebounceSettings(settings);
+}
+
+void ChessnutAdapter::setConnectionInterval(int intervalMicros) {
+    connectionIntervalMicros = intervalMicros;
+}
+
+void ChessnutAdapter::restoreCalibration(Stones const& stones) {
+    calibrator.setStoredStones(stones);
+}
+
+void ChessnutAdapter::setCalibrationStoreFunction(CalibrationStoreFunction storeFunction) {
+    calibrationStore = std::move(storeFunction);
+}
+
 void ChessnutAdapter::fromBle(uint8_t* data, size_t data_len) {
-    std::vector<uint8_t> result = converter.chessnutToCertaboCommand(data, data_len);
-    if (!result.empty() && isReady()) {
+    bool realTimeMode = converter.isRealTimeMode();
+    LedCommand result;
+    bool isLedCommand = converter.chessnutToCertaboCommand(data, data_len, result);
+    if (!realTimeMode && converter.isRealTimeMode()) {
+        // the app expects the current board when it switches to real time mode
+        resendBoard = true;
+    }
+    if (isLedCommand && isReady()) {
         ledCommand(result);
     }
 }
 
-void eboard::ChessnutAdapter::ledCommand(std::vector<uint8_t> const& command) {
+void eboard::ChessnutAdapter::ledCommand(LedCommand const& command) {
     ledControl.ledCommand(command);
 }
 
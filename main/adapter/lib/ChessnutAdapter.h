@@ -1,6 +1,8 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <vector>
@@ -10,12 +12,16 @@
 #include "CertaboCalibrator.h"
 #include "CertaboLedControl.h"
 #include "ChessnutConverter.h"
+#include "GestureTable.h"
 
 namespace eboard {
 
 /** Callback function for sending data via BLE. */
 using ToBleFunction = std::function<void(uint8_t* data, size_t data_len, bool isBoardData)>;
 
+/** Callback function for storing the stones of a completed calibration. */
+using CalibrationStoreFunction = std::function<void(Stones const& stones)>;
+
 /**
  * ChessnutAdapter adapts board data from Certabo to Chessnut and commands from Chessnut to Certabo.
  */
@@ -41,13 +47,56 @@ class ChessnutAdapter {
      * A direct LED command for Certabo, without any conversion
      * @param command the LED command
      */
-    void ledCommand(std::vector<uint8_t> const& command);
+    void ledCommand(LedCommand const& command);
 
     /**
      * @return whether the Certabo board is calibrated or the Sentio board is ready
      */
     bool isReady() const;
 
+    /**
+     * Set the interval after which an unchanged board is sent again, 0 disables re-sending unchanged boards.
+     * @param keepAliveMillis interval in milliseconds
+     */
+    void setKeepAliveInterval(int keepAliveMillis);
+
+    /**
+     * Set the number of boards used for the per-square majority vote of boards with piece recognition, e.g. 3, 5
+     * or 7. More boards reject more noise of a board model but add latency.
+     * @param depth number of boards, clamped to 1..MajorityFilter::MAX_DEPTH
+     */
+    void setHistoryDepth(size_t depth);
+
+    /**
+     * Set the limits for debouncing the occupied squares of boards without piece recognition, e.g. a slower or
+     * noisier Sentio board needs a longer settle time.
+     */
+    void setDebounceSettings(DebounceSettings const& settings);
+
+    /**
+     * Called when the BLE connection interval is negotiated. A changed board is not sent more than once per connection
+     * interval, a board held back is sent by sendPendingBoard once the interval has passed.
+     * @param connectionIntervalMicros connection interval in microseconds, 0 if unknown
+     */
+    void setConnectionInterval(int connectionIntervalMicros);
+
+    /**
+     * Send the latest changed board held back by the connection interval if the interval has passed.
+     * @return milliseconds until the board held back is due, -1 if no board is held back
+     */
+    int sendPendingBoard();
+
+    /**
+     * Restore a stored calibration, it is used if the first calibration board matches the starting position.
+     * @param stones stones of a previous calibration
+     */
+    void restoreCalibration(Stones const& stones);
+
+    /**
+     * Set the function called with the stones whenever calibration is complete.
+     */
+    void setCalibrationStoreFunction(CalibrationStoreFunction storeFunction);
+
   private:
     static std::array<eboard::StoneId, 64> const STANDARD_POSITION;
     static std::array<eboard::StoneId, 64> const WHITE_KING_A3;
@@ -59,10 +108,14 @@ class ChessnutAdapter {
     static std::array<eboard::StoneId, 64> const WHITE_KING_G3;
     static std::array<eboard::StoneId, 64> const WHITE_KING_H3;
 
-    static void clearBitForSquare(std::vector<uint8_t>& data, int square);
+    static void clearBitForSquare(LedCommand& data, int square);
     void lightCenterLeds();
+    /** Sends the board via BLE if it differs from the last one sent or the keep-alive interval has passed. */
+    void sendBoard(std::array<eboard::StoneId, 64> const& board);
 
-    std::vector<uint8_t> calibrationLeds;
+    /** special positions, looked up for every board */
+    GestureTable gestures;
+    LedCommand calibrationLeds;
     eboard::CertaboLedControl ledControl;
     ToBleFunction toBle;
     CertaboBoardMessageParser boardMessageParser;
@@ -71,6 +124,17 @@ class ChessnutAdapter {
     bool calibrationComplete = false;
     bool pieceRecognition = false;
     bool initialPositionReceived = false;
+    CalibrationStoreFunction calibrationStore;
+    std::array<eboard::StoneId, 64> lastSentBoard{};
+    bool boardSent = false;
+    /** set by fromBle on the BLE task, the next board is sent even if unchanged */
+    std::atomic_bool resendBoard{false};
+    std::chrono::steady_clock::time_point lastSentTime;
+    std::chrono::milliseconds keepAliveInterval{1000};
+    /** latest changed board received within the connection interval of the last board sent */
+    std::array<eboard::StoneId, 64> pendingBoard{};
+    bool boardPending = false;
+    std::atomic_int connectionIntervalMicros{0};
 };
 
 } // namespace eboard
@@ -4,6 +4,7 @@
 #include <functional>
 
 #include "CertaboCalibrator.h"
+#include "LedCommand.h"
 
 namespace eboard {
 
@@ -39,6 +40,7 @@ class ChessnutConverter {
      * 58 23 31 85 44 44 44 44 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 00 77 77 77 77 A6 C9 9B 6A
      * timestamp (four bytes with least significant byte first)
      * ]
+     * The last frame is kept, only the nibbles of changed squares and the timestamp are rewritten.
      * @param board internal board representation
      */
     void process(std::array<eboard::StoneId, 64> const& board);
@@ -49,16 +51,58 @@ class ChessnutConverter {
      * is called with the correct ack sequence.
      * @param data
      * @param data_len
-     * @return the command sequence
+     * @param ledCommand receives the Certabo LED command
+     * @return true if the command is an LED command and ledCommand was written
      */
-    std::vector<uint8_t> chessnutToCertaboCommand(uint8_t* data, size_t data_len);
+    bool chessnutToCertaboCommand(const uint8_t* data, size_t data_len, LedCommand& ledCommand);
+
+    /**
+     * @return whether board data is sent in real time
+     */
+    bool isRealTimeMode() const;
 
   private:
+    /** longest response, the firmware version */
+    static size_t const MAX_RESPONSE_SIZE = 15;
+
+    /**
+     * Handles a command and writes the response.
+     * @return length of the response, 0 if there is none
+     */
+    using CommandHandler = size_t (ChessnutConverter::*)(const uint8_t* data, uint8_t* response,
+                                                          LedCommand& ledCommand);
+
+    /** A Chessnut command is identified by its opcode and length byte */
+    struct Command {
+        uint8_t opcode;
+        uint8_t length;
+        /** minimum number of bytes received, including opcode and length byte */
+        uint8_t minSize;
+        bool isLedCommand;
+        CommandHandler handler;
+    };
+
+    /** Dispatch table of all handled commands */
+    static Command const COMMANDS[];
+
+    size_t mode(const uint8_t* data, uint8_t* response, LedCommand& ledCommand);
+    size_t batteryStatus(const uint8_t* data, uint8_t* response, LedCommand& ledCommand);
+    size_t filesCount(const uint8_t* data, uint8_t* response, LedCommand& ledCommand);
+    size_t dateTime(const uint8_t* data, uint8_t* response, LedCommand& ledCommand);
+    size_t firmwareVersion(const uint8_t* data, uint8_t* response, LedCommand& ledCommand);
+    size_t acknowledge(const uint8_t* data, uint8_t* response, LedCommand& ledCommand);
+    size_t leds(const uint8_t* data, uint8_t* response, LedCommand& ledCommand);
+
     static uint8_t setLowerNibble(uint8_t orig, uint8_t nibble);
     static uint8_t setUpperNibble(uint8_t orig, uint8_t nibble);
     static uint8_t stoneToChessnutStone(eboard::StoneId stone);
+    static void writeDateTime(uint8_t* out);
 
     ConverterCallbackFunction boardCallback;
+    /** last board frame, starting with the board message header and all squares empty */
+    std::array<uint8_t, 38> frame{0x01, 0x24};
+    /** board encoded in frame */
+    std::array<eboard::StoneId, 64> frameBoard{};
     ConverterCallbackFunction infoCallback;
     bool realTimeMode = false;
 };
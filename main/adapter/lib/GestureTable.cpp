@@ -0,0 +1,48 @@
+#include <cstring>
+
+#include "Bitboard.h"
+#include "GestureTable.h"
+
+using eboard::Gesture;
+using eboard::GestureTable;
+using eboard::StoneId;
+
+uint64_t GestureTable::fingerprint(std::array<StoneId, 64> const& board) {
+    // eight squares at a time, each word is mixed by Fibonacci hashing over all 64 bits
+    uint64_t hash = 0;
+    for (size_t i = 0; i < board.size(); i += 8) {
+        uint64_t word;
+        std::memcpy(&word, &board[i], sizeof(word));
+        hash = chess::fibonacciHash(hash ^ word, 64);
+        hash ^= hash >> 32;
+    }
+    return hash;
+}
+
+bool GestureTable::add(std::array<StoneId, 64> const& position, GestureAction action, uint8_t value) {
+    if (count == CAPACITY) {
+        return false;
+    }
+    uint64_t hash = fingerprint(position);
+    size_t index = hash & (CAPACITY - 1);
+    while (gestures[index].position != nullptr) {
+        index = (index + 1) & (CAPACITY - 1);
+    }
+    gestures[index] = Gesture{hash, action, value, &position};
+    count++;
+    return true;
+}
+
+Gesture const* GestureTable::find(std::array<StoneId, 64> const& board) const {
+    uint64_t hash = fingerprint(board);
+    for (size_t i = 0, index = hash & (CAPACITY - 1); i < CAPACITY; i++, index = (index + 1) & (CAPACITY - 1)) {
+        Gesture const& gesture = gestures[index];
+        if (gesture.position == nullptr) {
+            break;
+        }
+        if (gesture.fingerprint == hash && *gesture.position == board) {
+            return &gesture;
+        }
+    }
+    return nullptr;
+}
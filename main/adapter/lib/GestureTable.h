@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "Stones.h"
+
+namespace eboard {
+
+/**
+ * Action triggered when a special position is placed on the board.
+ */
+enum class GestureAction : uint8_t {
+    NONE,
+    /** the starting position */
+    INITIAL_POSITION,
+    /** set the LED brightness to the gesture value */
+    BRIGHTNESS,
+};
+
+struct Gesture {
+    uint64_t fingerprint;
+    GestureAction action;
+    uint8_t value;
+    /** the position itself, a matching fingerprint is confirmed by comparing the boards */
+    std::array<StoneId, 64> const* position;
+};
+
+/**
+ * Maps special positions to actions.
+ * Positions are looked up by fingerprint in an open addressing hash table, so the cost per board is one fingerprint
+ * and usually a single probe, independent of the number of gestures.
+ */
+class GestureTable {
+  public:
+    /** Capacity of the table, a power of two */
+    static size_t const CAPACITY = 32;
+
+    /**
+     * Adds a gesture, the position must outlive the table.
+     * @return false if the table is full
+     */
+    bool add(std::array<StoneId, 64> const& position, GestureAction action, uint8_t value = 0);
+
+    /**
+     * @return the gesture for the board or nullptr if the board is no special position
+     */
+    Gesture const* find(std::array<StoneId, 64> const& board) const;
+
+    /**
+     * Hash of a board, equal boards have the same fingerprint.
+     */
+    static uint64_t fingerprint(std::array<StoneId, 64> const& board);
+
+  private:
+    std::array<Gesture, CAPACITY> gestures{};
+    size_t count = 0;
+};
+
+} // namespace eboard
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace eboard {
+
+/**
+ * Certabo LED command, one bit for each square.
+ */
+using LedCommand = std::array<uint8_t, 8>;
+
+} // namespace eboard
@@ -0,0 +1,69 @@
+#include "LegalMoveIndex.h"
+
+using chess::Bitboard;
+using chess::LegalMoveIndex;
+
+size_t LegalMoveIndex::slot(Bitboard occupancy) {
+    return static_cast<size_t>(chess::fibonacciHash(occupancy, SLOT_BITS));
+}
+
+void LegalMoveIndex::build(Chess0x88& board) {
+    entries.fill(Entry{});
+    count = 0;
+    hash = board.getHash();
+    Bitboard before = board.getOccupancy();
+    for (uint32_t move : board.generate_moves()) {
+        if (!board.make_move(move)) {
+            continue;
+        }
+        Bitboard after = board.getOccupancy();
+        board.pop();
+        board.unmake_move(move);
+        Bitboard lifted = before & ~after;
+        if (get_move_capture(move) && !get_move_enpassant(move)) {
+            // the captured piece is lifted before the capturing piece is placed on its square
+            lifted |= squareMask(get_move_target_64(move));
+        }
+        insert(Entry{after, lifted, move});
+    }
+}
+
+uint64_t LegalMoveIndex::getHash() const {
+    return hash;
+}
+
+size_t LegalMoveIndex::size() const {
+    return count;
+}
+
+void LegalMoveIndex::insert(Entry const& entry) {
+    // keep one entry empty so lookups always terminate
+    if (count + 1 >= CAPACITY) {
+        return;
+    }
+    size_t index = slot(entry.occupancy);
+    while (entries[index].move != 0) {
+        index = (index + 1) & (CAPACITY - 1);
+    }
+    entries[index] = entry;
+    count++;
+}
+
+uint32_t LegalMoveIndex::find(Bitboard occupied, Bitboard lifted, uint32_t promoted_piece) const {
+    uint32_t result = 0;
+    for (size_t index = slot(occupied); entries[index].move != 0; index = (index + 1) & (CAPACITY - 1)) {
+        Entry const& entry = entries[index];
+        if (entry.occupancy != occupied || (lifted & entry.lifted) != entry.lifted) {
+            continue;
+        }
+        if (get_move_piece(entry.move) && get_move_piece(entry.move) != promoted_piece) {
+            continue;
+        }
+        if (result != 0) {
+            // e.g. two captured pieces were lifted and put back, the move is not known yet
+            return 0;
+        }
+        result = entry.move;
+    }
+    return result;
+}
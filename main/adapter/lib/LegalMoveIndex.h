@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "Bitboard.h"
+#include "Chess0x88.h"
+
+namespace chess {
+
+/**
+ * LegalMoveIndex holds the legal moves of one position, keyed by the occupancy after the move.
+ * Together with the squares where pieces were lifted, an occupancy-only board can be matched to a move
+ * with a single lookup, e.g. a capture needs the captured piece to be lifted as well.
+ */
+class LegalMoveIndex {
+  public:
+    static unsigned const SLOT_BITS = 8;
+    /** power of two, about twice the legal moves of any position reached in a game */
+    static size_t const CAPACITY = size_t{1} << SLOT_BITS;
+
+    /**
+     * Index the legal moves of the current position of the board.
+     * The board is unchanged afterwards.
+     */
+    void build(Chess0x88& board);
+
+    /** @return Zobrist hash of the indexed position */
+    uint64_t getHash() const;
+
+    size_t size() const;
+
+    /**
+     * Find the move which results in the given occupancy.
+     * @param occupied occupied squares, square 0 is a8
+     * @param lifted squares where a piece was lifted since the indexed position
+     * @param promoted_piece piece a pawn is promoted to, only used for promotion moves
+     * @return the encoded move, or 0 if there is no such move or more than one
+     */
+    uint32_t find(Bitboard occupied, Bitboard lifted, uint32_t promoted_piece) const;
+
+  private:
+    struct Entry {
+        Bitboard occupancy;
+        // squares which must be lifted: the source square, the captured piece and the rook when castling
+        Bitboard lifted;
+        // 0 marks an empty entry
+        uint32_t move;
+    };
+
+    static size_t slot(Bitboard occupancy);
+    void insert(Entry const& entry);
+
+    std::array<Entry, CAPACITY> entries{};
+    size_t count = 0;
+    uint64_t hash = 0;
+};
+
+} // namespace chess
@@ -0,0 +1,41 @@
+#include "LiftPlaceTracker.h"
+
+using chess::Bitboard;
+using chess::lowestSquare;
+using eboard::LiftPlaceTracker;
+using eboard::PieceEvent;
+
+void LiftPlaceTracker::update(Bitboard occupied) {
+    push(PieceEvent::LIFT, previous & ~occupied);
+    push(PieceEvent::PLACE, occupied & ~previous);
+    previous = occupied;
+}
+
+bool LiftPlaceTracker::nextEvent(PieceEvent& event) {
+    if (count == 0) {
+        return false;
+    }
+    event = events[head];
+    head = (head + 1) % CAPACITY;
+    count--;
+    return true;
+}
+
+size_t LiftPlaceTracker::pending() const {
+    return count;
+}
+
+size_t LiftPlaceTracker::dropped() const {
+    return droppedEvents;
+}
+
+void LiftPlaceTracker::push(PieceEvent::Type type, Bitboard squares) {
+    for (; squares != 0; squares &= squares - 1) {
+        if (count == CAPACITY) {
+            droppedEvents++;
+            continue;
+        }
+        events[(head + count) % CAPACITY] = PieceEvent{type, static_cast<uint8_t>(lowestSquare(squares))};
+        count++;
+    }
+}
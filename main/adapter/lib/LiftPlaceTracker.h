@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "Bitboard.h"
+
+namespace eboard {
+
+/**
+ * A piece was lifted from or placed on a square, square 0 is a8.
+ */
+struct PieceEvent {
+    enum Type : uint8_t { LIFT, PLACE };
+
+    Type type;
+    uint8_t square;
+};
+
+/**
+ * LiftPlaceTracker turns consecutive occupancy bitboards into a queue of lift and place events.
+ * The events are queued in square order per update, lifts before places. The occupancy before the first update is
+ * the empty board.
+ */
+class LiftPlaceTracker {
+  public:
+    /** one update changes at most all 64 squares */
+    static size_t const CAPACITY = 64;
+
+    /**
+     * Queue the events between the previous and the given occupancy.
+     * Events which do not fit into the queue are dropped and counted.
+     */
+    void update(chess::Bitboard occupied);
+
+    /**
+     * Take the oldest queued event.
+     * @return false if no event is queued
+     */
+    bool nextEvent(PieceEvent& event);
+
+    size_t pending() const;
+
+    size_t dropped() const;
+
+  private:
+    void push(PieceEvent::Type type, chess::Bitboard squares);
+
+    std::array<PieceEvent, CAPACITY> events{};
+    size_t head = 0;
+    size_t count = 0;
+    size_t droppedEvents = 0;
+    chess::Bitboard previous = 0;
+};
+
+} // namespace eboard
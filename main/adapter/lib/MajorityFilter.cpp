@@ -0,0 +1,59 @@
+#include <algorithm>
+
+#include "MajorityFilter.h"
+
+using eboard::MajorityFilter;
+using eboard::StoneId;
+
+size_t const MajorityFilter::MAX_DEPTH;
+
+void MajorityFilter::setDepth(size_t historyDepth) {
+    depth = std::max<size_t>(1, std::min(historyDepth, MAX_DEPTH));
+    count = 0;
+    newest = 0;
+}
+
+size_t MajorityFilter::getDepth() const {
+    return depth;
+}
+
+std::array<StoneId, 64> const& MajorityFilter::filter(std::array<StoneId, 64> const& newBoard) {
+    newest = count == 0 ? 0 : (newest + 1) % depth;
+    history[newest] = newBoard;
+    count = std::min(count + 1, depth);
+
+    if (count == 3) {
+        // 3-way compare, the comparisons are turned into byte masks so the loop has no branches
+        auto const& a = history[0];
+        auto const& b = history[1];
+        auto const& c = history[2];
+        for (size_t sq = 0; sq < 64; sq++) {
+            auto aWins = static_cast<StoneId>(-static_cast<int>(a[sq] == b[sq] || a[sq] == c[sq]));
+            auto bWins = static_cast<StoneId>(-static_cast<int>(b[sq] == c[sq]));
+            auto other = static_cast<StoneId>((bWins & b[sq]) | (~bWins & newBoard[sq]));
+            filtered[sq] = static_cast<StoneId>((aWins & a[sq]) | (~aWins & other));
+        }
+        return filtered;
+    }
+
+    for (size_t sq = 0; sq < 64; sq++) {
+        // Boyer-Moore majority vote, the candidate is verified in a second pass
+        StoneId candidate = newBoard[sq];
+        int votes = 0;
+        for (size_t i = 0; i < count; i++) {
+            StoneId stone = history[i][sq];
+            if (votes == 0) {
+                candidate = stone;
+                votes = 1;
+            } else {
+                votes += stone == candidate ? 1 : -1;
+            }
+        }
+        size_t occurrences = 0;
+        for (size_t i = 0; i < count; i++) {
+            occurrences += history[i][sq] == candidate;
+        }
+        filtered[sq] = occurrences * 2 > count ? candidate : newBoard[sq];
+    }
+    return filtered;
+}
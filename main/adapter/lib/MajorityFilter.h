@@ -0,0 +1,42 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "Stones.h"
+
+namespace eboard {
+
+/**
+ * MajorityFilter keeps the last boards in a fixed-capacity ring buffer and votes per square.
+ * A square gets the stone seen in more than half of the stored boards, otherwise the stone of the newest board.
+ */
+class MajorityFilter {
+  public:
+    static size_t const MAX_DEPTH = 7;
+    static size_t const DEFAULT_DEPTH = 3;
+
+    MajorityFilter() = default;
+
+    /**
+     * Set the number of boards to vote over, values are clamped to 1..MAX_DEPTH.
+     * Odd values avoid ties. Changing the depth clears the history.
+     */
+    void setDepth(size_t historyDepth);
+
+    size_t getDepth() const;
+
+    /**
+     * Adds a board to the history and returns the filtered board.
+     */
+    std::array<StoneId, 64> const& filter(std::array<StoneId, 64> const& newBoard);
+
+  private:
+    std::array<std::array<StoneId, 64>, MAX_DEPTH> history{};
+    std::array<StoneId, 64> filtered{};
+    size_t depth = DEFAULT_DEPTH;
+    size_t count = 0;
+    size_t newest = 0;
+};
+
+} // namespace eboard
@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <cstring>
+
+#include "NotificationQueue.h"
+
+using eboard::NotificationCounters;
+using eboard::NotificationQueue;
+using eboard::NotifyResult;
+
+NotificationQueue::NotificationQueue(NotifyFunction notify) : notify(std::move(notify)) {}
+
+bool NotificationQueue::send(const uint8_t* data, size_t data_len, bool isBoardData) {
+    if (data_len > MAX_NOTIFICATION_SIZE) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> guard(queueMutex);
+        if (!enqueueLocked(data, data_len, isBoardData)) {
+            return false;
+        }
+    }
+    flush();
+    return true;
+}
+
+bool NotificationQueue::enqueueLocked(const uint8_t* data, size_t data_len, bool isBoardData) {
+    Notification* slot = nullptr;
+    if (isBoardData) {
+        // the first notification may be sent right now, a newer board must not be lost when it is dequeued
+        for (size_t i = firstInFlight ? 1 : 0; i < count; i++) {
+            Notification& queued = notifications[(first + i) % CAPACITY];
+            if (queued.isBoardData) {
+                // keep the position of the older board, only the newest board matters to the app
+                slot = &queued;
+                counters.boardsCollapsed++;
+                break;
+            }
+        }
+    }
+    if (slot == nullptr) {
+        if (count == CAPACITY) {
+            counters.overflows++;
+            return false;
+        }
+        slot = &notifications[(first + count) % CAPACITY];
+        count++;
+    }
+    std::memcpy(slot->data.data(), data, data_len);
+    slot->length = static_cast<uint8_t>(data_len);
+    slot->isBoardData = isBoardData;
+    slot->queued = std::chrono::steady_clock::now();
+    return true;
+}
+
+void NotificationQueue::flush() {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    if (flushing) {
+        return;
+    }
+    flushing = true;
+    while (count > 0) {
+        // copy the notification, the BLE stack may call back into the queue while it is sent
+        Notification notification = notifications[first];
+        firstInFlight = true;
+        lock.unlock();
+        NotifyResult result = notify(notification.data.data(), notification.length, notification.isBoardData);
+        lock.lock();
+        if (result == NotifyResult::NO_BUFFER) {
+            counters.noBuffer++;
+            break;
+        }
+        if (result == NotifyResult::SENT) {
+            auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                                                 notification.queued);
+            counters.sent++;
+            counters.lastLatencyMicros = static_cast<uint32_t>(latency.count());
+            counters.maxLatencyMicros = std::max(counters.maxLatencyMicros, counters.lastLatencyMicros);
+        } else {
+            counters.failed++;
+        }
+        // the queue may have been cleared while sending
+        if (firstInFlight) {
+            first = (first + 1) % CAPACITY;
+            count--;
+        }
+    }
+    firstInFlight = false;
+    flushing = false;
+}
+
+void NotificationQueue::clear() {
+    std::lock_guard<std::mutex> guard(queueMutex);
+    first = 0;
+    count = 0;
+    firstInFlight = false;
+}
+
+size_t NotificationQueue::size() const {
+    std::lock_guard<std::mutex> guard(queueMutex);
+    return count;
+}
+
+NotificationCounters NotificationQueue::getCounters() const {
+    std::lock_guard<std::mutex> guard(queueMutex);
+    return counters;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+namespace eboard {
+
+/**
+ * Result of sending one notification.
+ */
+enum class NotifyResult {
+    SENT,
+    /** no buffer available, the notification is kept and sent again on the next flush */
+    NO_BUFFER,
+    /** sending failed for another reason, the notification is dropped */
+    FAILED,
+};
+
+/**
+ * Counters for BLE notifications, to tell a congested link in the field.
+ */
+struct NotificationCounters {
+    size_t sent = 0;
+    /** queued board notifications replaced by a newer board */
+    size_t boardsCollapsed = 0;
+    size_t noBuffer = 0;
+    size_t failed = 0;
+    /** notifications dropped because the queue was full */
+    size_t overflows = 0;
+    /** time between queueing and sending */
+    uint32_t maxLatencyMicros = 0;
+    uint32_t lastLatencyMicros = 0;
+};
+
+/**
+ * NotificationQueue keeps BLE notifications that could not be sent yet, in a fixed number of fixed-size slots.
+ * At most one board notification is queued, a newer board replaces it. Acknowledgements and other information are
+ * never replaced.
+ *
+ * The notify function is called without holding the lock, it may call send or flush again, e.g. from a BLE event
+ * raised while notifying. Only one thread sends at a time, a flush while another one is sending returns at once and
+ * leaves the queued notifications to it.
+ */
+class NotificationQueue {
+  public:
+    using NotifyFunction = std::function<NotifyResult(const uint8_t* data, size_t data_len, bool isBoardData)>;
+
+    static size_t const CAPACITY = 16;
+    /** size of a board notification, the longest one */
+    static size_t const MAX_NOTIFICATION_SIZE = 38;
+
+    explicit NotificationQueue(NotifyFunction notify);
+
+    /**
+     * Queue a notification and send as many queued notifications as possible.
+     * @return false if the notification is too long or the queue is full
+     */
+    bool send(const uint8_t* data, size_t data_len, bool isBoardData);
+
+    /**
+     * Send queued notifications in order until one cannot be sent, e.g. when buffers are available again.
+     */
+    void flush();
+
+    /**
+     * Drop all queued notifications, e.g. when the connection is closed.
+     */
+    void clear();
+
+    /**
+     * @return number of queued notifications, they are sent by the next flush when buffers are available again
+     */
+    size_t size() const;
+
+    NotificationCounters getCounters() const;
+
+  private:
+    struct Notification {
+        std::array<uint8_t, MAX_NOTIFICATION_SIZE> data;
+        uint8_t length;
+        bool isBoardData;
+        std::chrono::steady_clock::time_point queued;
+    };
+
+    /** queue a notification, replacing a queued board @return false if the queue is full */
+    bool enqueueLocked(const uint8_t* data, size_t data_len, bool isBoardData);
+
+    NotifyFunction notify;
+    std::array<Notification, CAPACITY> notifications{};
+    size_t first = 0;
+    size_t count = 0;
+    /** a thread is sending the queued notifications */
+    bool flushing = false;
+    /** the first notification is being sent without the lock held, it must not be replaced or dropped */
+    bool firstInFlight = false;
+    NotificationCounters counters;
+    mutable std::mutex queueMutex;
+};
+
+} // namespace eboard
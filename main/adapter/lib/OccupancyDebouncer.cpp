@@ -0,0 +1,69 @@
+#include <algorithm>
+
+#include "OccupancyDebouncer.h"
+
+using chess::Bitboard;
+using eboard::DebounceSettings;
+using eboard::OccupancyDebouncer;
+
+void OccupancyDebouncer::setSettings(DebounceSettings const& newSettings) {
+    settings = newSettings;
+    settings.minFrames = std::max<size_t>(1, settings.minFrames);
+    settings.maxFrames = std::max(settings.minFrames, settings.maxFrames);
+}
+
+DebounceSettings const& OccupancyDebouncer::getSettings() const {
+    return settings;
+}
+
+bool OccupancyDebouncer::update(Bitboard occupied, uint64_t nowMs) {
+    learnFrameInterval(nowMs);
+    if (frames == 0 || occupied != candidate) {
+        candidate = occupied;
+        frames = 1;
+        candidateSinceMs = nowMs;
+    } else {
+        frames++;
+    }
+    return frames >= getStableFrames() || nowMs - candidateSinceMs >= getStableTimeMs();
+}
+
+void OccupancyDebouncer::learnFrameInterval(uint64_t nowMs) {
+    if (frames != 0 && nowMs > lastFrameMs && nowMs - lastFrameMs <= MAX_FRAME_INTERVAL_MS) {
+        auto interval16 = static_cast<int32_t>((nowMs - lastFrameMs) * 16);
+        if (frameInterval16 == 0) {
+            frameInterval16 = interval16;
+        } else {
+            // a missed frame must not double the interval at once, a slower board is still learned over time
+            interval16 = std::min(interval16, static_cast<int32_t>(frameInterval16 * 2));
+            // exponential moving average with weight 1/8 for the newest interval
+            frameInterval16 += (interval16 - static_cast<int32_t>(frameInterval16)) / 8;
+        }
+    }
+    lastFrameMs = nowMs;
+}
+
+size_t OccupancyDebouncer::getConsecutiveFrames() const {
+    return frames;
+}
+
+uint32_t OccupancyDebouncer::getFrameIntervalMs() const {
+    return (frameInterval16 + 8) / 16;
+}
+
+size_t OccupancyDebouncer::getStableFrames() const {
+    if (frameInterval16 == 0) {
+        return settings.minFrames;
+    }
+    size_t stableFrames = (settings.settleTimeMs * 16 + frameInterval16 - 1) / frameInterval16;
+    return std::min(std::max(stableFrames, settings.minFrames), settings.maxFrames);
+}
+
+uint32_t OccupancyDebouncer::getStableTimeMs() const {
+    if (frameInterval16 == 0) {
+        return settings.maxStableTimeMs;
+    }
+    // the stable frames plus 50% slack, this only applies when frames are missed
+    uint32_t stableTime = static_cast<uint32_t>(getStableFrames() * frameInterval16 * 3 / 32);
+    return std::min(std::max(stableTime, settings.settleTimeMs), settings.maxStableTimeMs);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Bitboard.h"
+
+namespace eboard {
+
+/**
+ * Limits of the debounce window. The number of frames and the time an occupancy must be stable are learned from the
+ * observed frame rate within these limits.
+ */
+struct DebounceSettings {
+    /** time the occupancy should be stable, converted to a number of frames */
+    uint32_t settleTimeMs = 100;
+    size_t minFrames = 2;
+    size_t maxFrames = 8;
+    /** an occupancy stable for this long is processed even if frames were missed */
+    uint32_t maxStableTimeMs = 300;
+};
+
+/**
+ * OccupancyDebouncer tells when an occupancy is stable: it was seen in N consecutive frames or did not change for
+ * T ms. N and T follow the average frame interval, so fast boards are debounced in fewer milliseconds.
+ */
+class OccupancyDebouncer {
+  public:
+    /** frame gaps longer than this are pauses and are not used to learn the frame interval */
+    static uint32_t const MAX_FRAME_INTERVAL_MS = 1000;
+
+    OccupancyDebouncer() = default;
+
+    /**
+     * Set the limits, the learned frame interval is kept.
+     */
+    void setSettings(DebounceSettings const& newSettings);
+
+    DebounceSettings const& getSettings() const;
+
+    /**
+     * Add a frame.
+     * @param occupied occupied squares of the frame
+     * @param nowMs monotonic time of the frame in ms
+     * @return whether the occupancy is stable
+     */
+    bool update(chess::Bitboard occupied, uint64_t nowMs);
+
+    /** @return number of consecutive frames with the occupancy of the latest frame */
+    size_t getConsecutiveFrames() const;
+
+    /** @return learned frame interval in ms, 0 if not known yet */
+    uint32_t getFrameIntervalMs() const;
+
+    /** @return number of consecutive frames required for a stable occupancy */
+    size_t getStableFrames() const;
+
+    /** @return time in ms after which an unchanged occupancy is stable */
+    uint32_t getStableTimeMs() const;
+
+  private:
+    void learnFrameInterval(uint64_t nowMs);
+
+    DebounceSettings settings;
+    chess::Bitboard candidate = 0;
+    size_t frames = 0;
+    uint64_t candidateSinceMs = 0;
+    uint64_t lastFrameMs = 0;
+    // average frame interval in 1/16 ms
+    uint32_t frameInterval16 = 0;
+};
+
+} // namespace eboard
@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+
+#include "Profiler.h"
+
+using eboard::LatencyHistogram;
+using eboard::ProfileStage;
+using eboard::Profiler;
+
+void LatencyHistogram::add(uint64_t micros) {
+    size_t bucket = 0;
+    if (micros >= FIRST_BUCKET_MICROS) {
+        // 128..255 us is bucket 1, each further bit one bucket more
+        bucket = std::min<size_t>(64 - __builtin_clzll(micros) - 7, BUCKETS - 1);
+    }
+    buckets[bucket]++;
+    count++;
+    totalMicros += micros;
+    maxMicros = std::max(maxMicros, micros);
+}
+
+size_t LatencyHistogram::getCount() const {
+    return count;
+}
+
+size_t LatencyHistogram::getBucketCount(size_t bucket) const {
+    return buckets[bucket];
+}
+
+uint64_t LatencyHistogram::getMaxMicros() const {
+    return maxMicros;
+}
+
+uint64_t LatencyHistogram::getMeanMicros() const {
+    return count == 0 ? 0 : totalMicros / count;
+}
+
+uint64_t LatencyHistogram::getPercentileMicros(int percent) const {
+    if (count == 0) {
+        return 0;
+    }
+    size_t rank = (count * percent + 99) / 100;
+    size_t seen = 0;
+    for (size_t bucket = 0; bucket < BUCKETS - 1; bucket++) {
+        seen += buckets[bucket];
+        if (seen >= rank) {
+            return static_cast<uint64_t>(FIRST_BUCKET_MICROS) << bucket;
+        }
+    }
+    return maxMicros;
+}
+
+std::atomic<Profiler*> Profiler::installed{nullptr};
+
+Profiler::Profiler(ClockFunction clock) : clock(std::move(clock)) {}
+
+void Profiler::install(Profiler* profiler) {
+    installed = profiler;
+}
+
+void Profiler::mark(ProfileStage stage) {
+    Profiler* profiler = installed;
+    if (profiler != nullptr) {
+        profiler->record(stage);
+    }
+}
+
+void Profiler::record(ProfileStage stage) {
+    uint64_t now = clock();
+    auto index = static_cast<size_t>(stage);
+    std::lock_guard<std::mutex> guard(mutex);
+    if (stage == ProfileStage::USB_RX) {
+        // a frame spans several USB transfers, it starts with the first one
+        if (stageMicros[index] != 0 && stageMicros[static_cast<size_t>(ProfileStage::PARSED)] == 0) {
+            return;
+        }
+        stageMicros.fill(0);
+        stageMicros[index] = now;
+        return;
+    }
+    uint64_t previous = stageMicros[index - 1];
+    if (previous == 0) {
+        return;
+    }
+    histograms[index].add(now - previous);
+    stageMicros[index] = now;
+    if (stage == ProfileStage::NOTIFIED) {
+        // the USB_RX histogram holds the end-to-end latency
+        histograms[0].add(now - stageMicros[0]);
+        stageMicros.fill(0);
+    }
+}
+
+LatencyHistogram Profiler::getHistogram(ProfileStage stage) const {
+    std::lock_guard<std::mutex> guard(mutex);
+    return histograms[static_cast<size_t>(stage)];
+}
+
+void Profiler::reset() {
+    std::lock_guard<std::mutex> guard(mutex);
+    stageMicros.fill(0);
+    histograms.fill(LatencyHistogram());
+}
+
+std::string Profiler::report() const {
+    static char const* const NAMES[STAGES] = {"usb to ble", "parse", "translate", "encode", "notify"};
+    std::string result;
+    for (size_t stage = 0; stage < STAGES; stage++) {
+        LatencyHistogram histogram = getHistogram(static_cast<ProfileStage>(stage));
+        char line[128];
+        snprintf(line, sizeof(line), "%s: count %u, mean %llu us, p50 < %llu us, p90 < %llu us, max %llu us\n",
+                 NAMES[stage], static_cast<unsigned>(histogram.getCount()),
+                 static_cast<unsigned long long>(histogram.getMeanMicros()),
+                 static_cast<unsigned long long>(histogram.getPercentileMicros(50)),
+                 static_cast<unsigned long long>(histogram.getPercentileMicros(90)),
+                 static_cast<unsigned long long>(histogram.getMaxMicros()));
+        result += line;
+    }
+    return result;
+}
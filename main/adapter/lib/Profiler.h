@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+namespace eboard {
+
+/**
+ * Stages of a board frame on its way from the Certabo board to the app, in order.
+ */
+enum class ProfileStage : uint8_t {
+    /** data received via USB, starts a new frame unless the current frame is not parsed yet */
+    USB_RX,
+    /** board frame complete in CertaboParser */
+    PARSED,
+    /** stones or occupied squares translated to a board */
+    TRANSLATED,
+    /** board encoded by ChessnutConverter */
+    ENCODED,
+    /** board notification sent via BLE */
+    NOTIFIED,
+};
+
+/**
+ * Latency histogram with power of two buckets, bucket 0 counts latencies below 128 us, bucket n below 128 << n us.
+ * The last bucket counts everything above.
+ */
+class LatencyHistogram {
+  public:
+    static size_t const BUCKETS = 16;
+    static uint32_t const FIRST_BUCKET_MICROS = 128;
+
+    void add(uint64_t micros);
+
+    size_t getCount() const;
+    size_t getBucketCount(size_t bucket) const;
+    uint64_t getMaxMicros() const;
+    uint64_t getMeanMicros() const;
+
+    /**
+     * @return upper bound of the bucket containing the given percentile, 0 if there are no latencies
+     */
+    uint64_t getPercentileMicros(int percent) const;
+
+  private:
+    std::array<size_t, BUCKETS> buckets{};
+    size_t count = 0;
+    uint64_t totalMicros = 0;
+    uint64_t maxMicros = 0;
+};
+
+/**
+ * Profiler measures the latency of each stage of a frame, relative to the previous stage, and from USB receive to
+ * BLE notification. A stage is only measured if the previous stage was reached for the same frame, e.g. frames
+ * with an unchanged board are never encoded.
+ *
+ * The adapter library marks the stages on the installed profiler, without an installed profiler marks cost a
+ * single atomic load.
+ */
+class Profiler {
+  public:
+    /** monotonic time in microseconds, e.g. esp_timer_get_time */
+    using ClockFunction = std::function<uint64_t()>;
+
+    explicit Profiler(ClockFunction clock);
+
+    /**
+     * Install the profiler receiving the marks of the adapter library, nullptr to stop profiling.
+     */
+    static void install(Profiler* profiler);
+
+    /**
+     * Mark a stage of the current frame on the installed profiler.
+     */
+    static void mark(ProfileStage stage);
+
+    /**
+     * Mark a stage of the current frame.
+     */
+    void record(ProfileStage stage);
+
+    /**
+     * @return histogram of the time since the previous stage, for USB_RX the time from USB receive to BLE notification
+     */
+    LatencyHistogram getHistogram(ProfileStage stage) const;
+
+    void reset();
+
+    /**
+     * @return one line per stage with count, mean, median, 90th percentile and maximum latency
+     */
+    std::string report() const;
+
+  private:
+    static size_t const STAGES = static_cast<size_t>(ProfileStage::NOTIFIED) + 1;
+    static std::atomic<Profiler*> installed;
+
+    ClockFunction clock;
+    mutable std::mutex mutex;
+    // time each stage was reached for the current frame, 0 if not reached
+    std::array<uint64_t, STAGES> stageMicros{};
+    std::array<LatencyHistogram, STAGES> histograms{};
+};
+
+} // namespace eboard
@@ -1,54 +1,107 @@
-#include <cstring> // for memcpy
+#include <cstring>
 
 #include "RgbLedCommandTranslator.h"
 
+using eboard::LedRole;
+using eboard::Rgb;
 using eboard::RgbLedCommandTranslator;
 
-const int BOARD_SIZE = 8;
-const int LEDS_PER_ROW = 9;
-const int TOTAL_LEDS = 81;
-const int COLORS_PER_LED = 3;
-
-RgbLedCommandTranslator::RgbLedCommandTranslator() : brightness(0x40) {}
-
-std::vector<uint8_t> RgbLedCommandTranslator::translate(std::vector<uint8_t> const& command) {
-    std::vector<uint8_t> result = std::vector<uint8_t>(TOTAL_LEDS * COLORS_PER_LED);
-    // Process each bit of the command
-    for (int byteIndex = 0; byteIndex < command.size(); ++byteIndex) {
-        uint8_t currentByte = command[byteIndex];
-        for (int bitIndex = 0; bitIndex < 8; ++bitIndex) {
-            if (currentByte & (1 << bitIndex)) {
-                setColorForSquare(result, byteIndex * 8 + bitIndex, 0, 0, brightness);
-            }
-        }
+namespace {
+
+int const LEDS_PER_ROW = 9;
+int const COLORS_PER_LED = 3;
+size_t const HEADER_SIZE = 2;
+
+/** Index of the first colour byte of the four LEDs around each square, relative to the start of the LED values */
+struct SquareLeds {
+    uint8_t index[64][4];
+};
+
+constexpr SquareLeds squareLeds() {
+    SquareLeds result{};
+    for (int square = 0; square < 64; square++) {
+        int row = 7 - square / 8;
+        int col = 7 - square % 8;
+        int baseIndex = (row * LEDS_PER_ROW + col) * COLORS_PER_LED;
+        result.index[square][0] = baseIndex;
+        result.index[square][1] = baseIndex + COLORS_PER_LED;
+        result.index[square][2] = baseIndex + LEDS_PER_ROW * COLORS_PER_LED;
+        result.index[square][3] = baseIndex + LEDS_PER_ROW * COLORS_PER_LED + COLORS_PER_LED;
     }
-    return addStartEndBytes(result);
-}
-
-void RgbLedCommandTranslator::setColorForSquare(std::vector<uint8_t>& ledValues, int squareIndex, uint8_t r, uint8_t g,
-                                                uint8_t b) {
-    int row = 7 - squareIndex / BOARD_SIZE;
-    int col = 7 - squareIndex % BOARD_SIZE;
-    // Determine the indices of the LEDs for the given square
-    int baseIndex = (row * LEDS_PER_ROW + col) * COLORS_PER_LED;
-    int ledIndices[] = {baseIndex, baseIndex + COLORS_PER_LED, baseIndex + LEDS_PER_ROW * COLORS_PER_LED,
-                        baseIndex + LEDS_PER_ROW * COLORS_PER_LED + COLORS_PER_LED};
-    // Set color for the four LEDs of the specified square
-    for (int i : ledIndices) {
-        ledValues[i] = r;
-        ledValues[i + 1] = g;
-        ledValues[i + 2] = b;
+    return result;
+}
+
+constexpr SquareLeds SQUARE_LEDS = squareLeds();
+
+/** Colour channels per role, lit channels are set to the brightness */
+constexpr Rgb ROLE_CHANNELS[] = {
+    {0, 0, 0}, // OFF
+    {0, 0, 1}, // LIT
+    {0, 1, 0}, // FROM
+    {0, 0, 1}, // TO
+    {1, 0, 0}, // CHECK
+    {1, 1, 0}, // HINT
+};
+
+} // namespace
+
+RgbLedCommandTranslator::RgbLedCommandTranslator() : brightness(0x40) {
+    frame[0] = 255;
+    frame[1] = 85;
+    frame[FRAME_SIZE - 2] = 13;
+    frame[FRAME_SIZE - 1] = 10;
+}
+
+bool RgbLedCommandTranslator::translate(LedCommand const& command) {
+    for (int square = 0; square < 64; square++) {
+        bool lit = command[square / 8] & (1 << (square % 8));
+        setSquareRole(square, lit ? LedRole::LIT : LedRole::OFF);
     }
+    return update();
 }
 
-std::vector<uint8_t> RgbLedCommandTranslator::addStartEndBytes(const std::vector<uint8_t>& ledValues) {
-    std::vector<uint8_t> result(ledValues.size() + 4);
-    result[0] = 255;
-    result[1] = 85;
-    std::memcpy(&result[2], ledValues.data(), ledValues.size());
-    result[result.size() - 2] = 13;
-    result[result.size() - 1] = 10;
-    return result;
+void RgbLedCommandTranslator::setSquareRole(int square, LedRole role) {
+    Rgb const& channels = ROLE_CHANNELS[static_cast<int>(role)];
+    uint8_t value = brightness;
+    setSquareColor(square, Rgb{static_cast<uint8_t>(channels.r * value), static_cast<uint8_t>(channels.g * value),
+                               static_cast<uint8_t>(channels.b * value)});
+}
+
+void RgbLedCommandTranslator::setSquareColor(int square, Rgb color) {
+    if (squareColors[square] != color) {
+        squareColors[square] = color;
+        colorsChanged = true;
+    }
+}
+
+bool RgbLedCommandTranslator::update() {
+    if (!colorsChanged) {
+        return false;
+    }
+    colorsChanged = false;
+    render();
+    return true;
+}
+
+void RgbLedCommandTranslator::render() {
+    uint8_t* ledValues = &frame[HEADER_SIZE];
+    std::memset(ledValues, 0, FRAME_SIZE - 4);
+    // neighbouring squares share LEDs, a lit square with a higher index overwrites the shared LEDs
+    for (int square = 0; square < 64; square++) {
+        Rgb const& color = squareColors[square];
+        if (color == Rgb{0, 0, 0}) {
+            continue;
+        }
+        for (uint8_t i : SQUARE_LEDS.index[square]) {
+            ledValues[i] = color.r;
+            ledValues[i + 1] = color.g;
+            ledValues[i + 2] = color.b;
+        }
+    }
+}
+
+RgbLedCommandTranslator::Frame const& RgbLedCommandTranslator::getFrame() const {
+    return frame;
 }
 
 void RgbLedCommandTranslator::setBrightness(int brightnessValue) {
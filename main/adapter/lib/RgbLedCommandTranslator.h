@@ -1,24 +1,88 @@
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
-#include <vector>
+
+#include "LedCommand.h"
 
 namespace eboard {
 
+/**
+ * Colour of one RGB LED.
+ */
+struct Rgb {
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+
+    friend bool operator==(Rgb const& c1, Rgb const& c2) {
+        return c1.r == c2.r && c1.g == c2.g && c1.b == c2.b;
+    }
+
+    friend bool operator!=(Rgb const& c1, Rgb const& c2) {
+        return !(c1 == c2);
+    }
+};
+
+/**
+ * Meaning of a lit square, each role has its own colour.
+ */
+enum class LedRole : uint8_t {
+    OFF,
+    /** square lit by a Chessnut LED command */
+    LIT,
+    FROM,
+    TO,
+    CHECK,
+    HINT,
+};
+
+/**
+ * RgbLedCommandTranslator keeps the frame for Certabo boards with RGB LEDs.
+ * Each square is lit by the four LEDs at its corners, 9x9 LEDs in total. The frame is only rebuilt when a square
+ * colour changed and is written in place, including start and end bytes.
+ */
 class RgbLedCommandTranslator {
   public:
+    static size_t const FRAME_SIZE = 247;
+    using Frame = std::array<uint8_t, FRAME_SIZE>;
+
     RgbLedCommandTranslator();
-    std::vector<uint8_t> translate(std::vector<uint8_t> const& command);
+
+    /**
+     * Light the squares set in a Chessnut LED command, all other squares are turned off.
+     * @return true if the frame must be sent, i.e. it changed or was never sent before
+     */
+    bool translate(LedCommand const& command);
+
+    /**
+     * Set the role of a square, the colour is taken from the role and the current brightness.
+     */
+    void setSquareRole(int square, LedRole role);
+
+    /**
+     * Set the colour of a square, use update() to build the frame.
+     */
+    void setSquareColor(int square, Rgb color);
+
+    /**
+     * Rebuild the frame from the square colours.
+     * @return true if the frame must be sent, i.e. it changed or was never sent before
+     */
+    bool update();
+
+    Frame const& getFrame() const;
+
     void setBrightness(int brightnessValue);
 
   private:
-    /** Function to set color for a specific square */
-    void setColorForSquare(std::vector<uint8_t>& ledValues, int squareIndex, uint8_t r, uint8_t g, uint8_t b);
-
-    /** Add bytes at the beginning and end of the vector */
-    std::vector<uint8_t> addStartEndBytes(const std::vector<uint8_t>& ledValues);
+    void render();
 
+    std::array<Rgb, 64> squareColors{};
+    bool colorsChanged = true;
+    Frame frame{};
     std::atomic_int brightness;
 };
 
@@ -1,22 +1,19 @@
-#include <algorithm>
 #include <chrono>
 #include <utility>
 
 #include "ChessData.h"
 #include "Sentio.h"
 
+using chess::Bitboard;
+using chess::lowestSquare;
 using chess::pieces;
+using chess::popCount;
+using chess::squareMask;
 using eboard::ChessData;
+using eboard::PieceEvent;
 using eboard::Sentio;
 using eboard::StoneId;
 
-const std::vector<uint8_t> Sentio::SQUARES_INITIAL_POSITION = {
-    0,  1,  2,  3,  4,  5,  6,  7,  //
-    8,  9,  10, 11, 12, 13, 14, 15, //
-    48, 49, 50, 51, 52, 53, 54, 55, //
-    56, 57, 58, 59, 60, 61, 62, 63, //
-};
-
 Sentio::Sentio(BoardCallbackFunction callbackFunction) : callback(std::move(callbackFunction)) {}
 
 Sentio::Sentio(eboard::BoardCallbackFunction callbackFunction, chess::Chess0x88 initialBoard)
@@ -37,50 +34,78 @@ const std::map<int, int> Sentio::PIECE_TO_STONE_ID{
     {pieces::k, ChessData::BLACK_KING},   //
 };
 
-void Sentio::occupiedSquares(std::array<bool, 64> const& occupied) {
+void Sentio::occupiedSquares(Bitboard occupied) {
     lastReceivedOccupiedSquares = occupied;
     uint64_t currentTime =
         std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
             .count();
+    bool stable = debouncer.update(occupied, currentTime);
+    if (resolveMove(occupied)) {
+        return;
+    }
     if (lastProcessedOccupiedSquares == lastReceivedOccupiedSquares) {
-        if ((lastBoardSendTime + MIN_TIME_TO_PROCESS_MS) <= currentTime) {
+        if ((lastBoardSendTime + RESEND_INTERVAL_MS) <= currentTime) {
             callback(lastBoardArray);
             lastBoardSendTime = currentTime;
         }
         return;
     }
-    if ((lastProcessTime + MIN_TIME_TO_PROCESS_MS) <= currentTime) {
+    if (stable) {
         processOccupiedSquares(occupied);
     }
 }
 
-void Sentio::processOccupiedSquares(const std::array<bool, 64>& occupied) {
+void Sentio::setDebounceSettings(DebounceSettings const& settings) {
+    debouncer.setSettings(settings);
+}
+
+bool Sentio::resolveMove(Bitboard occupied) {
+    if (moveIndex.getHash() != board.getHash()) {
+        moveIndex.build(board);
+        liftedSquares = 0;
+    }
+    // a misread square lasts a single frame, only occupancies seen in consecutive frames are lifts and places
+    if (debouncer.getConsecutiveFrames() < debouncer.getSettings().minFrames) {
+        return false;
+    }
+    tracker.update(occupied);
+    PieceEvent event{};
+    while (tracker.nextEvent(event)) {
+        if (event.type == PieceEvent::LIFT) {
+            liftedSquares |= squareMask(event.square);
+        }
+    }
+    if (occupied == board.getOccupancy()) {
+        // all pieces are back on their squares
+        liftedSquares = 0;
+        return false;
+    }
+    uint32_t promoteTo = board.getSideToMove() == chess::white ? promoteToPieceWhite : promoteToPieceBlack;
+    uint32_t move = moveIndex.find(occupied, liftedSquares, promoteTo);
+    if (move == 0 || !board.make_move(move)) {
+        return false;
+    }
+    // the move is complete when the last piece is placed, no need to wait for the full debounce window
+    resetPromoteToPieces();
+    capturePiece.reset();
     lastProcessedOccupiedSquares = occupied;
-    lastProcessTime =
-        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
-            .count();
-    std::vector<uint8_t> expectedSquares = board.getOccupiedSquares();
-    std::vector<uint8_t> occupiedSquares = toSquares(occupied);
-    if (expectedSquares == occupiedSquares) {
+    callCallback(toBoardArray(board));
+    return true;
+}
+
+void Sentio::processOccupiedSquares(Bitboard occupied) {
+    lastProcessedOccupiedSquares = occupied;
+    Bitboard expected = board.getOccupancy();
+    if (expected == occupied) {
         callCallback(toBoardArray(board));
-    } else if (occupiedSquares == SQUARES_INITIAL_POSITION) {
+    } else if (occupied == OCCUPANCY_INITIAL_POSITION) {
         if (!board.isStartPosition()) {
             board = chess::Chess0x88();
         }
         callCallback(toBoardArray(board));
-    } else if (!takeBackMove(occupiedSquares)) {
-        checkValidMove(expectedSquares, occupiedSquares);
-    }
-}
-
-std::vector<uint8_t> Sentio::toSquares(const std::array<bool, 64>& occupied) {
-    std::vector<uint8_t> result;
-    for (int i = 0; i < occupied.size(); i++) {
-        if (occupied[i]) {
-            result.push_back(i);
-        }
+    } else if (!takeBackMove(occupied)) {
+        checkValidMove(expected, occupied);
     }
-    return result;
 }
 
 void Sentio::callCallback(std::array<StoneId, 64> const& boardArray) {
@@ -101,70 +126,61 @@ std::array<StoneId, 64> Sentio::toBoardArray(chess::Chess0x88& chessBoard) {
     return result;
 }
 
-bool eboard::Sentio::takeBackMove(std::vector<uint8_t> const& occupiedSquares) {
-    uint32_t previousMove = board.pop();
-    if (previousMove != 0) {
-        board.unmake_move(previousMove);
-        if (board.getOccupiedSquares() == occupiedSquares) {
-            callCallback(toBoardArray(board));
-            return true;
-        } else {
-            board.make_move(previousMove);
-        }
+bool eboard::Sentio::takeBackMove(Bitboard occupied) {
+    // the latest earlier position with this occupancy, so several moves can be taken back at once
+    int moveCount = board.findOccupancy(occupied);
+    if (moveCount == 0) {
+        return false;
     }
-    return false;
+    for (int i = 0; i < moveCount; i++) {
+        board.unmake_move(board.pop());
+    }
+    // lifting pieces for the take back may have looked like the start of a capture
+    capturePiece.reset();
+    callCallback(toBoardArray(board));
+    return true;
 }
 
-void eboard::Sentio::checkValidMove(std::vector<uint8_t> const& expectedSquares,
-                                    std::vector<uint8_t> const& occupiedSquares) {
-    std::vector<uint8_t> missing;
-    std::vector<uint8_t> extra;
-    setDifference(expectedSquares, occupiedSquares, missing, extra);
-    if (!nonCaptureMove(occupiedSquares, missing, extra)) {
+void eboard::Sentio::checkValidMove(Bitboard expected, Bitboard occupied) {
+    Bitboard missing = expected & ~occupied;
+    Bitboard extra = occupied & ~expected;
+    if (!nonCaptureMove(occupied, missing, extra)) {
         if (!captureMove(missing, extra)) {
             incompleteMove(missing);
         }
     }
 }
 
-void eboard::Sentio::setDifference(const std::vector<uint8_t>& expectedSquares,
-                                   const std::vector<uint8_t>& occupiedSquares, std::vector<uint8_t>& missing,
-                                   std::vector<uint8_t>& extra) {
-    std::set_difference(expectedSquares.begin(), expectedSquares.end(), occupiedSquares.begin(), occupiedSquares.end(),
-                        std::inserter(missing, missing.begin()));
-    std::set_difference(occupiedSquares.begin(), occupiedSquares.end(), expectedSquares.begin(), expectedSquares.end(),
-                        std::inserter(extra, extra.begin()));
-}
-
 static uint8_t toBoardArraySquare(uint8_t sq) {
     uint8_t file = sq & 7;
     uint8_t rank = sq / 8;
     return (7 - rank) * 8 + file;
 }
 
-bool eboard::Sentio::nonCaptureMove(std::vector<uint8_t> const& occupiedSquares, std::vector<uint8_t> const& missing,
-                                    std::vector<uint8_t> const& extra) {
-    if (capturePiece == nullptr && missing.size() == 1 && extra.size() == 1) {
-        if (makeMove(missing[0], extra[0])) {
-            std::vector<uint8_t> expectedSquares = board.getOccupiedSquares();
-            if (expectedSquares == occupiedSquares) {
+bool eboard::Sentio::nonCaptureMove(Bitboard occupied, Bitboard missing, Bitboard extra) {
+    if (capturePiece == nullptr && popCount(missing) == 1 && popCount(extra) == 1) {
+        uint8_t fromSquare = lowestSquare(missing);
+        uint8_t toSquare = lowestSquare(extra);
+        if (makeMove(fromSquare, toSquare)) {
+            Bitboard expected = board.getOccupancy();
+            if (expected == occupied) {
                 callCallback(toBoardArray(board));
             } else {
                 // special handling for castling - rook needs to move as well
-                std::vector<uint8_t> miss;
-                std::vector<uint8_t> ex;
-                setDifference(expectedSquares, occupiedSquares, miss, ex);
-                if (miss.size() == 1 && ex.size() == 1) {
+                Bitboard miss = expected & ~occupied;
+                Bitboard ex = occupied & ~expected;
+                if (popCount(miss) == 1 && popCount(ex) == 1) {
                     std::array<StoneId, 64> boardArray = toBoardArray(board);
-                    boardArray[toBoardArraySquare(ex[0])] = PIECE_TO_STONE_ID.at(board.getPiece(miss[0]));
-                    boardArray[toBoardArraySquare(miss[0])] = 0;
+                    boardArray[toBoardArraySquare(lowestSquare(ex))] =
+                        PIECE_TO_STONE_ID.at(board.getPiece(lowestSquare(miss)));
+                    boardArray[toBoardArraySquare(lowestSquare(miss))] = 0;
                     callCallback(boardArray);
                 }
             }
         } else {
             std::array<StoneId, 64> boardArray = toBoardArray(board);
-            boardArray[toBoardArraySquare(extra[0])] = board.getPiece(missing[0]);
-            boardArray[toBoardArraySquare(missing[0])] = 0;
+            boardArray[toBoardArraySquare(toSquare)] = board.getPiece(fromSquare);
+            boardArray[toBoardArraySquare(fromSquare)] = 0;
             callCallback(boardArray);
         }
         return true;
@@ -172,22 +188,23 @@ bool eboard::Sentio::nonCaptureMove(std::vector<uint8_t> const& occupiedSquares,
     return false;
 }
 
-void eboard::Sentio::incompleteMove(std::vector<uint8_t> const& missing) {
+void eboard::Sentio::incompleteMove(Bitboard missing) {
     checkForPromotionPieceChange(missing);
-    if (!missing.empty()) {
+    if (missing != 0) {
         std::array<StoneId, 64> boardArray = toBoardArray(board);
-        for (auto sq : missing) {
-            boardArray[toBoardArraySquare(sq)] = 0;
+        for (Bitboard squares = missing; squares != 0; squares &= squares - 1) {
+            boardArray[toBoardArraySquare(lowestSquare(squares))] = 0;
         }
         callCallback(boardArray);
     }
 }
 
-void eboard::Sentio::checkForPromotionPieceChange(const std::vector<uint8_t>& missing) {
-    if (missing.size() == 2 || missing.size() == 3) {
+void eboard::Sentio::checkForPromotionPieceChange(Bitboard missing) {
+    if (popCount(missing) == 2 || popCount(missing) == 3) {
         uint8_t kingSquare = 128; // invalid square
         uint8_t pawnSquare = 128; // invalid square
-        for (auto sq : missing) {
+        for (Bitboard squares = missing; squares != 0; squares &= squares - 1) {
+            uint8_t sq = lowestSquare(squares);
             uint8_t piece = board.getPiece(sq);
             if (piece == chess::K || piece == chess::k) {
                 kingSquare = sq;
@@ -211,20 +228,22 @@ void eboard::Sentio::checkForPromotionPieceChange(const std::vector<uint8_t>& mi
     }
 }
 
-bool eboard::Sentio::captureMove(std::vector<uint8_t> const& missing, std::vector<uint8_t> const& extra) {
-    if (missing.size() == 2 && extra.empty()) {
-        if (board.getPieceColor(missing[0]) != board.getPieceColor(missing[1])) {
-            if (board.getPieceColor(missing[0]) == board.getSideToMove()) {
-                capturePiece = std::make_unique<CapturePiece>(board.getPiece(missing[0]), missing[0], missing[1]);
+bool eboard::Sentio::captureMove(Bitboard missing, Bitboard extra) {
+    if (popCount(missing) == 2 && extra == 0) {
+        uint8_t firstSquare = lowestSquare(missing);
+        uint8_t secondSquare = lowestSquare(missing & (missing - 1));
+        if (board.getPieceColor(firstSquare) != board.getPieceColor(secondSquare)) {
+            if (board.getPieceColor(firstSquare) == board.getSideToMove()) {
+                capturePiece = std::make_unique<CapturePiece>(board.getPiece(firstSquare), firstSquare, secondSquare);
             } else {
-                capturePiece = std::make_unique<CapturePiece>(board.getPiece(missing[1]), missing[1], missing[0]);
+                capturePiece = std::make_unique<CapturePiece>(board.getPiece(secondSquare), secondSquare, firstSquare);
             }
         } else {
             capturePiece.reset();
         }
         std::array<StoneId, 64> boardArray = toBoardArray(board);
-        boardArray[toBoardArraySquare(missing[0])] = 0;
-        boardArray[toBoardArraySquare(missing[1])] = 0;
+        boardArray[toBoardArraySquare(firstSquare)] = 0;
+        boardArray[toBoardArraySquare(secondSquare)] = 0;
         callCallback(boardArray);
     } else if (capturePiece != nullptr && isPossibleCapture(missing, extra)) {
         uint8_t fromSquare = capturePiece->getFromSquare();
@@ -235,7 +254,7 @@ bool eboard::Sentio::captureMove(std::vector<uint8_t> const& missing, std::vecto
         return result;
     } else if (capturePiece != nullptr && isPossibleEpCapture(missing, extra)) {
         uint8_t fromSquare = capturePiece->getFromSquare();
-        uint8_t toSquare = extra[0];
+        uint8_t toSquare = lowestSquare(extra);
         capturePiece.reset();
         bool result = makeMove(fromSquare, toSquare);
         callCallback(toBoardArray(board));
@@ -245,15 +264,11 @@ bool eboard::Sentio::captureMove(std::vector<uint8_t> const& missing, std::vecto
 }
 
 bool eboard::Sentio::makeMove(uint8_t fromSquare, uint8_t toSquare) {
-    auto moves = board.generate_moves();
-    for (uint32_t move : moves) {
-        if (fromSquare == get_move_source_64(move) && toSquare == get_move_target_64(move)) {
-            uint32_t promoPiece = get_move_piece(move);
-            if (!promoPiece || promoPiece == promoteToPieceWhite || promoPiece == promoteToPieceBlack) {
-                resetPromoteToPieces();
-                return board.make_move(move);
-            }
-        }
+    uint32_t promoteTo = board.getSideToMove() == chess::white ? promoteToPieceWhite : promoteToPieceBlack;
+    uint32_t move = board.find_move(fromSquare, toSquare, promoteTo);
+    if (move != 0) {
+        resetPromoteToPieces();
+        return board.make_move(move);
     }
     return false;
 }
@@ -263,11 +278,11 @@ void eboard::Sentio::resetPromoteToPieces() {
     promoteToPieceBlack = chess::q;
 }
 
-bool eboard::Sentio::isPossibleCapture(std::vector<uint8_t> const& missing, std::vector<uint8_t> const& extra) {
-    return missing.size() == 1 && extra.empty();
+bool eboard::Sentio::isPossibleCapture(Bitboard missing, Bitboard extra) {
+    return popCount(missing) == 1 && extra == 0;
 }
 
-bool eboard::Sentio::isPossibleEpCapture(std::vector<uint8_t> const& missing, std::vector<uint8_t> const& extra) {
-    return missing.size() == 2 && extra.size() == 1 &&
+bool eboard::Sentio::isPossibleEpCapture(Bitboard missing, Bitboard extra) {
+    return popCount(missing) == 2 && popCount(extra) == 1 &&
            (capturePiece->getPiece() == chess::pieces::P || capturePiece->getPiece() == chess::pieces::p);
 }
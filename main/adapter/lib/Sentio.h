@@ -7,6 +7,9 @@
 #include "CapturePiece.h"
 #include "CertaboCalibrator.h"
 #include "Chess0x88.h"
+#include "LegalMoveIndex.h"
+#include "LiftPlaceTracker.h"
+#include "OccupancyDebouncer.h"
 
 namespace eboard {
 
@@ -14,46 +17,57 @@ using BoardCallbackFunction = std::function<void(std::array<StoneId, 64> const&)
 
 class Sentio {
   public:
-    static uint64_t const MIN_TIME_TO_PROCESS_MS = 300;
+    /** interval for sending the unchanged board again */
+    static uint64_t const RESEND_INTERVAL_MS = 300;
 
     explicit Sentio(BoardCallbackFunction callbackFunction);
 
     Sentio(BoardCallbackFunction callbackFunction, chess::Chess0x88 initialBoard);
 
-    void occupiedSquares(std::array<bool, 64> const& occupied);
+    /**
+     * Process the occupied squares of the board.
+     * @param occupied bit n is set if square n is occupied, square 0 is a8
+     */
+    void occupiedSquares(chess::Bitboard occupied);
+
+    /**
+     * Set the limits for debouncing the occupied squares, see OccupancyDebouncer.
+     */
+    void setDebounceSettings(DebounceSettings const& settings);
 
   private:
-    static const std::vector<uint8_t> SQUARES_INITIAL_POSITION;
+    static chess::Bitboard const OCCUPANCY_INITIAL_POSITION = 0xFFFF00000000FFFFULL;
     static const std::map<int, int> PIECE_TO_STONE_ID;
 
-    void processOccupiedSquares(const std::array<bool, 64>& occupied);
-    static std::vector<uint8_t> toSquares(const std::array<bool, 64>& occupied);
+    bool resolveMove(chess::Bitboard occupied);
+    void processOccupiedSquares(chess::Bitboard occupied);
     void callCallback(std::array<StoneId, 64> const& boardArray);
     static std::array<StoneId, 64> toBoardArray(chess::Chess0x88& chessBoard);
-    bool takeBackMove(std::vector<uint8_t> const& occupiedSquares);
-    void checkValidMove(std::vector<uint8_t> const& expectedSquares, std::vector<uint8_t> const& occupiedSquares);
-    static void setDifference(const std::vector<uint8_t>& expectedSquares, const std::vector<uint8_t>& occupiedSquares,
-                        std::vector<uint8_t>& missing, std::vector<uint8_t>& extra) ;
-    bool nonCaptureMove(std::vector<uint8_t> const& occupied, std::vector<uint8_t> const& missing,
-                        std::vector<uint8_t> const& extra);
-    bool captureMove(std::vector<uint8_t> const& missing, std::vector<uint8_t> const& extra);
-    void incompleteMove(std::vector<uint8_t> const& missing);
-    void checkForPromotionPieceChange(const std::vector<uint8_t>& missing);
+    bool takeBackMove(chess::Bitboard occupied);
+    void checkValidMove(chess::Bitboard expected, chess::Bitboard occupied);
+    bool nonCaptureMove(chess::Bitboard occupied, chess::Bitboard missing, chess::Bitboard extra);
+    bool captureMove(chess::Bitboard missing, chess::Bitboard extra);
+    void incompleteMove(chess::Bitboard missing);
+    void checkForPromotionPieceChange(chess::Bitboard missing);
     bool makeMove(uint8_t fromSquare, uint8_t toSquare);
     void resetPromoteToPieces();
-    static bool isPossibleCapture(std::vector<uint8_t> const& missing, std::vector<uint8_t> const& extra);
-    bool isPossibleEpCapture(std::vector<uint8_t> const& missing, std::vector<uint8_t> const& extra);
+    static bool isPossibleCapture(chess::Bitboard missing, chess::Bitboard extra);
+    bool isPossibleEpCapture(chess::Bitboard missing, chess::Bitboard extra);
 
     BoardCallbackFunction callback;
     chess::Chess0x88 board;
     uint32_t promoteToPieceWhite = chess::pieces::Q;
     uint32_t promoteToPieceBlack = chess::pieces::q;
     std::unique_ptr<CapturePiece> capturePiece;
-    std::array<bool, 64> lastProcessedOccupiedSquares{};
-    std::array<bool, 64> lastReceivedOccupiedSquares{};
+    LiftPlaceTracker tracker;
+    chess::LegalMoveIndex moveIndex;
+    // squares where a piece was lifted since the indexed position was last at rest
+    chess::Bitboard liftedSquares = 0;
+    OccupancyDebouncer debouncer;
+    chess::Bitboard lastProcessedOccupiedSquares = 0;
+    chess::Bitboard lastReceivedOccupiedSquares = 0;
     std::array<StoneId, 64> lastBoardArray{};
     uint64_t lastBoardSendTime = 0;
-    uint64_t lastProcessTime = 0;
 };
 
 } // namespace eboard
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace eboard {
+
+/**
+ * Lock-free byte ring buffer for exactly one producer and one consumer thread.
+ * The producer only writes the head index and the consumer only writes the tail index, so neither side blocks.
+ * CAPACITY must be a power of two.
+ */
+template <size_t CAPACITY>
+class SpscRingBuffer {
+    static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0, "capacity must be a power of two");
+
+  public:
+    /**
+     * Called by the producer. Data is only written if it fits completely.
+     * @return false if there is not enough room, the data is dropped in this case
+     */
+    bool push(const uint8_t* data, size_t data_len) {
+        size_t head = this->head.load(std::memory_order_relaxed);
+        size_t tail = this->tail.load(std::memory_order_acquire);
+        if (CAPACITY - (head - tail) < data_len) {
+            droppedBytes.fetch_add(data_len, std::memory_order_relaxed);
+            return false;
+        }
+        for (size_t i = 0; i < data_len; i++) {
+            buffer[(head + i) & (CAPACITY - 1)] = data[i];
+        }
+        this->head.store(head + data_len, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Called by the consumer.
+     * @return number of bytes copied to data, at most data_len
+     */
+    size_t pop(uint8_t* data, size_t data_len) {
+        size_t tail = this->tail.load(std::memory_order_relaxed);
+        size_t head = this->head.load(std::memory_order_acquire);
+        size_t count = std::min(data_len, head - tail);
+        for (size_t i = 0; i < count; i++) {
+            data[i] = buffer[(tail + i) & (CAPACITY - 1)];
+        }
+        this->tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @return number of bytes dropped by push because the buffer was full
+     */
+    size_t dropped() const {
+        return droppedBytes.load(std::memory_order_relaxed);
+    }
+
+  private:
+    uint8_t buffer[CAPACITY];
+    std::atomic<size_t> head{0};
+    std::atomic<size_t> tail{0};
+    std::atomic<size_t> droppedBytes{0};
+};
+
+} // namespace eboard
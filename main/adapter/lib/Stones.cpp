@@ -0,0 +1,88 @@
+#include <algorithm>
+
+#include "Stones.h"
+#include "Bitboard.h"
+#include "ChessData.h"
+
+using eboard::StoneId;
+using eboard::Stones;
+
+size_t Stones::slot(uint64_t key) {
+    return static_cast<size_t>(chess::fibonacciHash(key, SLOT_BITS));
+}
+
+bool Stones::insert(CertaboPiece const& piece, StoneId stone) {
+    uint64_t key = piece.getKey();
+    if (key == 0) {
+        return true;
+    }
+    for (size_t i = 0, index = slot(key); i < CAPACITY; i++, index = (index + 1) & (CAPACITY - 1)) {
+        if (keys[index] == key) {
+            stones[index] = stone;
+            return true;
+        }
+        if (keys[index] == 0) {
+            keys[index] = key;
+            stones[index] = stone;
+            count++;
+            return true;
+        }
+    }
+    return false;
+}
+
+StoneId Stones::find(CertaboPiece const& piece) const {
+    uint64_t key = piece.getKey();
+    if (key == 0) {
+        return ChessData::NO_STONE;
+    }
+    for (size_t i = 0, index = slot(key); i < CAPACITY; i++, index = (index + 1) & (CAPACITY - 1)) {
+        if (keys[index] == key) {
+            return stones[index];
+        }
+        if (keys[index] == 0) {
+            break;
+        }
+    }
+    return ChessData::NO_STONE;
+}
+
+size_t Stones::size() const {
+    return count;
+}
+
+bool Stones::empty() const {
+    return count == 0;
+}
+
+std::vector<uint8_t> Stones::serialize() const {
+    std::vector<uint8_t> result{'S', 'T', FORMAT_VERSION, static_cast<uint8_t>(count)};
+    result.reserve(HEADER_SIZE + count * ENTRY_SIZE);
+    for (size_t i = 0; i < CAPACITY; i++) {
+        if (keys[i] != 0) {
+            // piece ID bytes, most significant first
+            for (int shift = 32; shift >= 0; shift -= 8) {
+                result.push_back((keys[i] >> shift) & 0xff);
+            }
+            result.push_back(stones[i]);
+        }
+    }
+    return result;
+}
+
+bool Stones::deserialize(const uint8_t* data, size_t data_len) {
+    if (data_len < HEADER_SIZE || data[0] != 'S' || data[1] != 'T' || data[2] != FORMAT_VERSION ||
+        data_len != HEADER_SIZE + data[3] * ENTRY_SIZE) {
+        return false;
+    }
+    Stones result;
+    for (size_t pos = HEADER_SIZE; pos < data_len; pos += ENTRY_SIZE) {
+        PieceId pieceId;
+        std::copy(&data[pos], &data[pos] + pieceId.size(), pieceId.begin());
+        if (!result.insert(CertaboPiece(pieceId), data[pos + pieceId.size()])) {
+            return false;
+        }
+    }
+    *this = result;
+    return true;
+}
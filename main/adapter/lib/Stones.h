@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "CertaboPiece.h"
+
+namespace eboard {
+
+using StoneId = uint8_t;
+
+/**
+ * Maps raw Certabo piece IDs to individual chess stones.
+ * The table is an open addressing hash table with linear probing and a fixed capacity, it is filled once after
+ * calibration and lookups neither allocate nor compare more than a few keys.
+ */
+class Stones {
+  public:
+    static unsigned const SLOT_BITS = 6;
+    /** Capacity of the table, a power of two well above the 34 pieces that can be calibrated. */
+    static size_t const CAPACITY = size_t{1} << SLOT_BITS;
+
+    /**
+     * Adds or replaces the stone for a piece. The empty piece is never added.
+     * @return false if the table is full
+     */
+    bool insert(CertaboPiece const& piece, StoneId stone);
+
+    /**
+     * @return the stone for the piece or ChessData::NO_STONE if the piece is unknown
+     */
+    StoneId find(CertaboPiece const& piece) const;
+
+    size_t size() const;
+
+    bool empty() const;
+
+    /**
+     * Serializes the table to a compact binary format for persistent storage.
+     * The format is the magic bytes "ST", a version byte and the number of entries, followed by the five ID bytes and
+     * the stone of each entry.
+     */
+    std::vector<uint8_t> serialize() const;
+
+    /**
+     * Replaces the table with serialized data.
+     * @return false if the data is invalid, the table is not changed in this case
+     */
+    bool deserialize(const uint8_t* data, size_t data_len);
+
+  private:
+    static uint8_t const FORMAT_VERSION = 1;
+    static size_t const HEADER_SIZE = 4;
+    static size_t const ENTRY_SIZE = 6;
+
+    static size_t slot(uint64_t key);
+
+    /** keys of the pieces, 0 (the empty piece) marks a free slot */
+    std::array<uint64_t, CAPACITY> keys{};
+    std::array<StoneId, CAPACITY> stones{};
+    size_t count = 0;
+};
+
+} // namespace eboard
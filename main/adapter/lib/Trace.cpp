@@ -0,0 +1,74 @@
+#include <utility>
+
+#include "Trace.h"
+
+using eboard::TraceRecord;
+using eboard::TraceRecordType;
+using eboard::TraceWriter;
+
+uint8_t const TraceWriter::MAGIC[4] = {'C', '2', 'N', 'T'};
+
+TraceWriter::TraceWriter(OutputFunction output) : output(std::move(output)) {}
+
+size_t TraceWriter::encodeVarint(uint64_t value, uint8_t* out) {
+    size_t len = 0;
+    while (value >= 0x80) {
+        out[len++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    out[len++] = static_cast<uint8_t>(value);
+    return len;
+}
+
+void TraceWriter::record(TraceRecordType type, uint64_t timeMicros, const uint8_t* data, size_t data_len) {
+    if (!headerWritten) {
+        uint8_t header[5] = {MAGIC[0], MAGIC[1], MAGIC[2], MAGIC[3], VERSION};
+        output(header, sizeof(header));
+        headerWritten = true;
+        lastTimeMicros = timeMicros;
+    }
+    // type, up to 10 bytes time delta and up to 10 bytes length
+    uint8_t recordHeader[21];
+    size_t len = 0;
+    recordHeader[len++] = static_cast<uint8_t>(type);
+    len += encodeVarint(timeMicros >= lastTimeMicros ? timeMicros - lastTimeMicros : 0, &recordHeader[len]);
+    len += encodeVarint(data_len, &recordHeader[len]);
+    output(recordHeader, len);
+    if (data_len > 0) {
+        output(data, data_len);
+    }
+    lastTimeMicros = timeMicros;
+}
+
+static bool decodeVarint(std::vector<uint8_t> const& trace, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && pos < trace.size(); shift += 7) {
+        uint8_t b = trace[pos++];
+        value |= static_cast<uint64_t>(b & 0x7f) << shift;
+        if ((b & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool eboard::decodeTrace(std::vector<uint8_t> const& trace, std::vector<TraceRecord>& records) {
+    if (trace.size() < 5 || trace[0] != TraceWriter::MAGIC[0] || trace[1] != TraceWriter::MAGIC[1] ||
+        trace[2] != TraceWriter::MAGIC[2] || trace[3] != TraceWriter::MAGIC[3] || trace[4] != TraceWriter::VERSION) {
+        return false;
+    }
+    size_t pos = 5;
+    uint64_t timeMicros = 0;
+    while (pos < trace.size()) {
+        auto type = static_cast<TraceRecordType>(trace[pos++]);
+        uint64_t delta;
+        uint64_t len;
+        if (!decodeVarint(trace, pos, delta) || !decodeVarint(trace, pos, len) || len > trace.size() - pos) {
+            return false;
+        }
+        timeMicros += delta;
+        records.push_back(TraceRecord{type, timeMicros, std::vector<uint8_t>(trace.begin() + pos, trace.begin() + pos + len)});
+        pos += len;
+    }
+    return true;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace eboard {
+
+/**
+ * Record types of a trace, named after the direction as seen by the adapter.
+ */
+enum class TraceRecordType : uint8_t {
+    /** data received from the Certabo board via USB */
+    USB_RX = 1,
+    /** data written by the app via BLE */
+    BLE_WRITE = 2,
+    /** board notification sent to the app */
+    BLE_NOTIFY_BOARD = 3,
+    /** acknowledgement or other information sent to the app */
+    BLE_NOTIFY_INFO = 4,
+};
+
+struct TraceRecord {
+    TraceRecordType type;
+    /** time since the start of the trace in microseconds */
+    uint64_t timeMicros;
+    std::vector<uint8_t> data;
+};
+
+/**
+ * Writes USB and BLE traffic in a compact binary format.
+ *
+ * The trace starts with the magic bytes "C2NT" and a version byte. Each record consists of the record type, the
+ * time since the previous record in microseconds and the data length, both as unsigned LEB128 varints, followed by the
+ * data. The writer does not allocate, encoded bytes are passed to the output function.
+ */
+class TraceWriter {
+  public:
+    using OutputFunction = std::function<void(const uint8_t* data, size_t data_len)>;
+
+    static uint8_t const MAGIC[4];
+    static uint8_t const VERSION = 1;
+
+    explicit TraceWriter(OutputFunction output);
+
+    /**
+     * Writes a record, the header is written before the first record.
+     * @param type record type
+     * @param timeMicros monotonic time in microseconds
+     */
+    void record(TraceRecordType type, uint64_t timeMicros, const uint8_t* data, size_t data_len);
+
+  private:
+    static size_t encodeVarint(uint64_t value, uint8_t* out);
+
+    OutputFunction output;
+    bool headerWritten = false;
+    uint64_t lastTimeMicros = 0;
+};
+
+/**
+ * Decodes a complete trace.
+ * @param trace the trace bytes including the header
+ * @param records decoded records, times are relative to the first record
+ * @return false if the header is invalid or the trace is truncated
+ */
+bool decodeTrace(std::vector<uint8_t> const& trace, std::vector<TraceRecord>& records);
+
+} // namespace eboard
@@ -0,0 +1,56 @@
+#include <cstring>
+
+#include "UsbTxQueue.h"
+
+using eboard::UsbTxQueue;
+
+UsbTxQueue::UsbTxQueue(TransferFunction transfer) : transfer(std::move(transfer)) {
+    transferThread = std::thread([this]() { processFrames(); });
+}
+
+UsbTxQueue::~UsbTxQueue() {
+    {
+        std::lock_guard<std::mutex> guard(frameMutex);
+        keepRunning = false;
+    }
+    frameCondition.notify_all();
+    if (transferThread.joinable()) {
+        transferThread.join();
+    }
+}
+
+bool UsbTxQueue::send(const uint8_t* data, size_t data_len) {
+    if (data_len == 0 || data_len > MAX_FRAME_SIZE) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> guard(frameMutex);
+        if (pendingLength > 0) {
+            droppedFrames++;
+        }
+        std::memcpy(pendingFrame.data(), data, data_len);
+        pendingLength = data_len;
+    }
+    frameCondition.notify_all();
+    return true;
+}
+
+size_t UsbTxQueue::dropped() const {
+    return droppedFrames;
+}
+
+void UsbTxQueue::processFrames() {
+    std::unique_lock<std::mutex> lock(frameMutex);
+    while (true) {
+        frameCondition.wait(lock, [this]() { return pendingLength > 0 || !keepRunning; });
+        if (!keepRunning) {
+            return;
+        }
+        size_t length = pendingLength;
+        std::memcpy(transferFrame.data(), pendingFrame.data(), length);
+        pendingLength = 0;
+        lock.unlock();
+        transfer(transferFrame.data(), length);
+        lock.lock();
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace eboard {
+
+/**
+ * UsbTxQueue decouples senders from blocking USB transfers.
+ * A separate thread performs one transfer at a time. While a transfer is in flight, only the latest queued frame is
+ * kept, older pending frames are dropped. Frames are copied into fixed buffers sized for the largest RGB LED command.
+ */
+class UsbTxQueue {
+  public:
+    /** Blocking transfer function, called from the queue thread only */
+    using TransferFunction = std::function<void(uint8_t* data, size_t data_len)>;
+
+    /** size of an RGB LED command: 2 header bytes, 3 color bytes for each of the 81 LEDs and CR LF */
+    static size_t const MAX_FRAME_SIZE = 247;
+
+    explicit UsbTxQueue(TransferFunction transfer);
+
+    ~UsbTxQueue();
+
+    /**
+     * Queue a frame for transfer, replacing a frame that is still pending. Does not wait for the transfer.
+     * @return false if the frame is empty or larger than MAX_FRAME_SIZE
+     */
+    bool send(const uint8_t* data, size_t data_len);
+
+    /**
+     * @return number of frames that were replaced before they could be transferred
+     */
+    size_t dropped() const;
+
+  private:
+    void processFrames();
+
+    TransferFunction transfer;
+    std::array<uint8_t, MAX_FRAME_SIZE> pendingFrame{};
+    size_t pendingLength = 0;
+    std::array<uint8_t, MAX_FRAME_SIZE> transferFrame{};
+    std::atomic<size_t> droppedFrames{0};
+    bool keepRunning = true;
+    std::mutex frameMutex;
+    std::condition_variable frameCondition;
+    std::thread transferThread;
+};
+
+} // namespace eboard
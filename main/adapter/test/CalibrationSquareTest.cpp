@@ -0,0 +1,69 @@
+#include <gmock/gmock.h>
+
+#include "CalibrationSquare.h"
+#include "ChessData.h"
+
+using eboard::CalibrationSquare;
+using eboard::CertaboPiece;
+using eboard::ChessData;
+using eboard::PieceId;
+
+class CalibrationSquareTest : public ::testing::Test {
+  protected:
+    static CertaboPiece piece(uint8_t b) {
+        return CertaboPiece(PieceId{48, 0, 248, 71, b});
+    }
+
+    void whenFramesAreReceived(CertaboPiece const& pc, int frames) {
+        for (int i = 0; i < frames && !square.isCalibrated(); i++) {
+            square.calibratePiece(pc, [this](int sq) { completedSquares.push_back(sq); });
+        }
+    }
+
+    void thenSquareShouldBeCalibratedWith(CertaboPiece const& pc) {
+        EXPECT_TRUE(square.isCalibrated());
+        EXPECT_EQ(pc, square.getPiece());
+        EXPECT_EQ(std::vector<int>{56}, completedSquares);
+    }
+
+    void thenSquareShouldNotBeCalibrated() {
+        EXPECT_FALSE(square.isCalibrated());
+        EXPECT_TRUE(completedSquares.empty());
+    }
+
+  private:
+    CalibrationSquare square{0};
+    std::vector<int> completedSquares;
+};
+
+TEST_F(CalibrationSquareTest, calibratedAfterMinimumFrames) {
+    whenFramesAreReceived(piece(99), 6);
+    thenSquareShouldNotBeCalibrated();
+    whenFramesAreReceived(piece(99), 1);
+    thenSquareShouldBeCalibratedWith(piece(99));
+}
+
+TEST_F(CalibrationSquareTest, misreadsDoNotPreventCalibration) {
+    for (uint8_t b = 1; b <= 6; b++) {
+        whenFramesAreReceived(piece(b), 1);
+        whenFramesAreReceived(piece(99), 1);
+    }
+    thenSquareShouldNotBeCalibrated();
+    whenFramesAreReceived(piece(99), 2);
+    thenSquareShouldBeCalibratedWith(piece(99));
+}
+
+TEST_F(CalibrationSquareTest, olderFramesLoseWeight) {
+    for (int i = 0; i < 16; i++) {
+        whenFramesAreReceived(piece(i % 3), 1);
+    }
+    whenFramesAreReceived(piece(99), 8);
+    thenSquareShouldNotBeCalibrated();
+    whenFramesAreReceived(piece(99), 1);
+    thenSquareShouldBeCalibratedWith(piece(99));
+}
+
+TEST_F(CalibrationSquareTest, emptySquareIsNotCalibrated) {
+    whenFramesAreReceived(CertaboPiece(), 20);
+    thenSquareShouldNotBeCalibrated();
+}
@@ -0,0 +1,58 @@
+#include <gmock/gmock.h>
+
+#include "CertaboLedControl.h"
+
+using eboard::CertaboLedControl;
+using eboard::LedCommand;
+
+class CertaboLedControlTest : public ::testing::Test {
+  protected:
+    void givenLedsWithoutRgb() {
+        ledControl.ledsDetected(false);
+        ledControl.setProcessingTime(100);
+    }
+
+    static std::vector<uint8_t> bytes(LedCommand const& command) {
+        return std::vector<uint8_t>(command.begin(), command.end());
+    }
+
+    std::vector<std::vector<uint8_t>> sentCommands() {
+        std::lock_guard<std::mutex> guard(sentMutex);
+        return sent;
+    }
+
+    std::mutex sentMutex;
+    std::vector<std::vector<uint8_t>> sent;
+    CertaboLedControl ledControl{[this](uint8_t* data, size_t data_len) {
+        std::lock_guard<std::mutex> guard(sentMutex);
+        sent.emplace_back(data, data + data_len);
+    }};
+};
+
+TEST_F(CertaboLedControlTest, latestPendingCommandWins) {
+    givenLedsWithoutRgb();
+    LedCommand first{1, 0, 0, 0, 0, 0, 0, 0};
+    LedCommand second{2, 0, 0, 0, 0, 0, 0, 0};
+    LedCommand third{4, 0, 0, 0, 0, 0, 0, 0};
+    ledControl.ledCommand(first);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ledControl.ledCommand(second);
+    ledControl.ledCommand(third);
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    std::vector<std::vector<uint8_t>> expected{bytes(first), bytes(third)};
+    EXPECT_EQ(expected, sentCommands());
+}
+
+TEST_F(CertaboLedControlTest, commandBeforeLedsOffIsKept) {
+    givenLedsWithoutRgb();
+    LedCommand first{1, 0, 0, 0, 0, 0, 0, 0};
+    LedCommand second{2, 0, 0, 0, 0, 0, 0, 0};
+    LedCommand ledsOff{0, 0, 0, 0, 0, 0, 0, 0};
+    ledControl.ledCommand(first);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ledControl.ledCommand(second);
+    ledControl.ledCommand(ledsOff);
+    std::this_thread::sleep_for(std::chrono::milliseconds(350));
+    std::vector<std::vector<uint8_t>> expected{bytes(first), bytes(second), bytes(ledsOff)};
+    EXPECT_EQ(expected, sentCommands());
+}
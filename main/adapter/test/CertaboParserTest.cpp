@@ -18,8 +18,8 @@ class CertaboParserTest : public ::testing::Test {
     class MockBoardTranslator : public BoardTranslator {
       public:
         MOCK_METHOD(void, hasPieceRecognition, (bool pieceRecognition), (override));
-        MOCK_METHOD(void, translate, (std::vector<CertaboPiece> const& board), (override));
-        MOCK_METHOD(void, translateOccupiedSquares, ((std::array<bool, 64> const& occupied)), (override));
+        MOCK_METHOD(void, translate, (eboard::CertaboBoard const& board), (override));
+        MOCK_METHOD(void, translateOccupiedSquares, (uint64_t occupied), (override));
         MOCK_METHOD(void, ledsDetected, (bool hasRgbLeds), (override));
     };
 
@@ -50,7 +50,7 @@ class CertaboParserTest : public ::testing::Test {
         EXPECT_CALL(translator, translateOccupiedSquares(_)).Times(times);
     }
 
-    void expectTranslateOccupiedSquaresToBeCalledWith(std::array<bool, 64> const& expected) {
+    void expectTranslateOccupiedSquaresToBeCalledWith(uint64_t expected) {
         EXPECT_CALL(translator, translateOccupiedSquares(expected)).Times(1);
     }
 
@@ -177,16 +177,7 @@ TEST_F(CertaboParserTest, parsePositionTabutronic) {
 }
 
 TEST_F(CertaboParserTest, parsePositionTabutronicOnePieceMissing) {
-    std::array<bool, 64> board{
-        true,  true,  true,  true,  true,  true,  true,  true,  //
-        true,  true,  true,  true,  true,  true,  true,  true,  //
-        false, false, false, false, false, false, false, false, //
-        false, false, false, false, false, false, false, false, //
-        false, false, false, false, false, false, false, false, //
-        false, false, false, false, false, false, false, false, //
-        true,  true,  true,  true,  true,  true,  true,  true,  //
-        true,  true,  true,  true,  true,  true,  true,  false, //
-    };
+    uint64_t board = 0x7FFF00000000FFFFULL; // square 63 (h1) is empty
     expectTranslateOccupiedSquaresToBeCalledWith(board);
     whenParseIsCalledWith(":255 255 0 0 0 0 255 254\nL\r\n");
 }
@@ -200,3 +191,128 @@ TEST_F(CertaboParserTest, detectRgbLedBoard) {
     expectLedsDetectedToBeCalledWith(true);
     whenParseIsCalledWith(":255 255 0 0 0 0 255 254\nD\r\n");
 }
+
+TEST_F(CertaboParserTest, parsePositionByteByByte) {
+    expectTranslateToBeCalled();
+    std::string position(
+        ":3 0 84 252 153 3 0 85 0 104 3 0 84 2 3 3 0 83 177 224 3 0 84 107 52 3 0 84 240 106 "
+        "3 0 85 0 107 3 0 84 255 174 3 0 84 44 81 3 0 84 121 210 3 0 84 242 13 3 0 84 107 56 3 0 84 78 193 "
+        "3 0 84 240 84 3 0 84 240 65 3 0 84 68 134 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 160 80 "
+        "7 140 126 32 250 15 0 0 254 7 118 237 181 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 "
+        "0 160 225 80 192 121 0 0 0 0 0 207 224 74 7 172 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 3 0 85 1 184 0 0 0 0 0 "
+        "0 0 0 0 0 100 115 213 250 161 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 186 10 56 165 201 0 0 0 0 0 168 "
+        "94 211 7 40 74 124 195 174 25 3 0 84 44 165 3 0 84 68 112 3 0 84 237 98 3 0 84 252 170 0 0 0 0 0 3 0 "
+        "84 78 209 3 0 84 242 11 3 0 84 78 216 3 0 85 0 16 3 0 83 229 13 3 0 85 0 67 3 0 84 121 142 3 0 84 105 "
+        "128 3 0 84 106 231 3 0 84 247 87 3 0 84 252 15\r\n");
+    for (char c : position) {
+        whenParseIsCalledWith(std::string(1, c));
+    }
+}
+
+TEST_F(CertaboParserTest, valueOutOfRangeIsInvalid) {
+    expectTranslateOccupiedSquaresToBeCalled(0);
+    whenParseIsCalledWith(":255 256 0 0 0 0 255 255\r\n");
+}
+
+class CertaboParserChunkTest : public ::testing::Test {
+  protected:
+    /** Records the reported frames, a real USB stream is split at arbitrary positions. */
+    class RecordingTranslator : public BoardTranslator {
+      public:
+        void hasPieceRecognition(bool) override {}
+
+        void translate(eboard::CertaboBoard const& board) override {
+            boards.push_back(board);
+        }
+
+        void translateOccupiedSquares(uint64_t occupied) override {
+            occupancies.push_back(occupied);
+        }
+
+        void ledsDetected(bool) override {}
+
+        std::vector<eboard::CertaboBoard> boards;
+        std::vector<uint64_t> occupancies;
+    };
+
+    void givenRecordedStream(std::string const& str) {
+        stream = str;
+        reference = whenParsedInChunks({});
+    }
+
+    /**
+     * @param splits ascending positions at which the stream is split into chunks
+     */
+    RecordingTranslator whenParsedInChunks(std::vector<size_t> const& splits) {
+        RecordingTranslator translator;
+        CertaboParser parser(translator);
+        auto data = reinterpret_cast<uint8_t const*>(stream.data());
+        size_t pos = 0;
+        for (size_t split : splits) {
+            parser.parse(data + pos, split - pos);
+            pos = split;
+        }
+        parser.parse(data + pos, stream.size() - pos);
+        return translator;
+    }
+
+    void expectReferenceFrames(size_t boards, size_t occupancies) {
+        EXPECT_EQ(boards, reference.boards.size());
+        EXPECT_EQ(occupancies, reference.occupancies.size());
+    }
+
+    void thenFramesAreSameAsReference(RecordingTranslator const& translator, std::vector<size_t> const& splits) {
+        EXPECT_EQ(reference.boards, translator.boards) << "split at " << ::testing::PrintToString(splits);
+        EXPECT_EQ(reference.occupancies, translator.occupancies) << "split at " << ::testing::PrintToString(splits);
+    }
+
+    std::string stream;
+    RecordingTranslator reference;
+};
+
+TEST_F(CertaboParserChunkTest, pieceFramesAreNotLostOrDuplicatedAtAnySplit) {
+    givenRecordedStream(
+        "xx:3 0 84 252 153 3 0 85 0 104 3 0 84 2 3 3 0 83 177 224 3 0 84 107 52 3 0 84 240 106 "
+        "3 0 85 0 107 3 0 84 255 174 3 0 84 44 81 3 0 84 121 210 3 0 84 242 13 3 0 84 107 56 3 0 84 78 193 "
+        "3 0 84 240 84 3 0 84 240 65 3 0 84 68 134 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 160 80 "
+        "7 140 126 32 250 15 0 0 254 7 118 237 181 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 "
+        "0 160 225 80 192 121 0 0 0 0 0 207 224 74 7 172 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 3 0 85 1 184 0 0 0 0 0 "
+        "0 0 0 0 0 100 115 213 250 161 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 186 10 56 165 201 0 0 0 0 0 168 "
+        "94 211 7 40 74 124 195 174 25 3 0 84 44 165 3 0 84 68 112 3 0 84 237 98 3 0 84 252 170 0 0 0 0 0 3 0 "
+        "84 78 209 3 0 84 242 11 3 0 84 78 216 3 0 85 0 16 3 0 83 229 13 3 0 85 0 67 3 0 84 121 142 3 0 84 105 "
+        "128 3 0 84 106 231 3 0 84 247 87 3 0 84 252 15\r\n"
+        "L\r\n"
+        ":3 0 84 252 153 3 0 85 0 104 3 0 84 240 106 3 0 83 177 224 3 0 8\n"
+        "4 107 52 3 0 84 2 3 3 0 85 0 107 3 0 84 255 174 3 0 84 44 81 3 0\n"
+        " 84 121 210 3 0 84 242 13 3 0 84 78 193 3 0 84 107 56 3 0 84 240\n"
+        " 84 3 0 84 240 65 3 0 84 68 134 252 64 88 0 32 0 0 0 0 0 0 0 0 0\n"
+        " 0 0 0 0 0 0 239 108 5 136 0 243 32 12 0 240 0 0 0 0 0 251 13 24\n"
+        "1 4 192 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 221 12\n"
+        " 87 1 12 255 194 176 204 0 0 0 0 0 0 226 2 224 8 96 143 182 230 \n"
+        "16 5 120 132 14 0 16 0 0 0 0 0 204 146 3 24 0 231 0 20 3 3 0 0 0\n"
+        " 0 0 121 129 0 5 0 0 0 0 0 0 0 0 0 0 0 112 177 230 48 0 0 0 0 0 \n"
+        "0 0 0 0 0 0 0 0 0 0 0 239 134 225 66 240 0 0 0 0 0 3 0 84 44 165\n"
+        " 3 0 84 68 112 3 0 85 1 184 3 0 84 78 209 3 0 84 242 11 3 0 84 7\n"
+        "8 216 3 0 84 237 98 3 0 84 252 15 3 0 85 0 16 3 0 83 229 13 3 0 \n"
+        "85 0 67 3 0 84 121 142 3 0 84 105 128 3 0 84 106 231 3 0 84 247 \n"
+        "87 3 0 84 252 170\nL\r\n");
+    expectReferenceFrames(2, 0);
+    for (size_t split = 1; split < stream.size(); split++) {
+        thenFramesAreSameAsReference(whenParsedInChunks({split}), {split});
+    }
+}
+
+TEST_F(CertaboParserChunkTest, occupancyFramesAreNotLostOrDuplicatedAtAnyTwoSplits) {
+    givenRecordedStream(":255 255 0 0 0 0 255 255\r\n"
+                        ":255 255 0 0 0 0 255 254\nL\r\n"
+                        ":255 239 0 16 0 0 255 255\r\n"
+                        ":255 256 0 0 0 0 255 255\r\n"
+                        "\r\n"
+                        ":255 239 0 16 8 0 247 255\r\n");
+    expectReferenceFrames(0, 4);
+    for (size_t first = 1; first < stream.size(); first++) {
+        for (size_t second = first; second < stream.size(); second++) {
+            thenFramesAreSameAsReference(whenParsedInChunks({first, second}), {first, second});
+        }
+    }
+}
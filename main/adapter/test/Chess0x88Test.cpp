@@ -1,5 +1,6 @@
 #include <gmock/gmock.h>
 
+#include <utility>
 #include <vector>
 
 #include "Chess0x88.h"
@@ -18,10 +19,68 @@ class Chess0x88Test : public ::testing::Test {
         EXPECT_EQ(expected, instance->getOccupiedSquares());
     }
 
+    void thenOccupancyShouldBe(chess::Bitboard expected) {
+        EXPECT_EQ(expected, instance->getOccupancy());
+    }
+
     void thenPieceAtSquareShouldBe(uint8_t rank, uint8_t file, chess::pieces expectedPiece) {
         EXPECT_EQ(expectedPiece, instance->getPiece(rank, file));
     }
 
+    void givenPosition(std::string const& fen) {
+        instance->parse_fen(fen.c_str());
+    }
+
+    void whenFindingMove(int fromSquare, int toSquare, int promotedPiece) {
+        foundMove = instance->find_move(fromSquare, toSquare, promotedPiece);
+    }
+
+    void thenFoundMoveShouldBe(int fromSquare, int toSquare, int promotedPiece) {
+        ASSERT_NE(0, foundMove);
+        EXPECT_EQ(fromSquare, get_move_source_64(foundMove));
+        EXPECT_EQ(toSquare, get_move_target_64(foundMove));
+        EXPECT_EQ(promotedPiece, get_move_piece(foundMove));
+    }
+
+    void thenNoMoveShouldBeFound() {
+        EXPECT_EQ(0, foundMove);
+    }
+
+    void givenMovesAreMade(std::vector<std::pair<int, int>> const& moves) {
+        for (auto const& move : moves) {
+            ASSERT_TRUE(instance->make_move(instance->find_move(move.first, move.second, 0)));
+        }
+    }
+
+    void whenTakingBackMoves(int count) {
+        for (int i = 0; i < count; i++) {
+            instance->unmake_move(instance->pop());
+        }
+    }
+
+    void whenEachMoveIsMadeAndTakenBack() {
+        for (uint32_t move : instance->generate_moves()) {
+            if (instance->make_move(move)) {
+                instance->unmake_move(instance->pop());
+            }
+        }
+    }
+
+    void thenHashShouldBeHashOf(std::string const& fen) {
+        Chess0x88 expected;
+        expected.parse_fen(fen.c_str());
+        EXPECT_EQ(expected.getHash(), instance->getHash());
+        EXPECT_EQ(expected.getOccupancy(), instance->getOccupancy());
+    }
+
+    void thenMovesToTakeBackShouldBe(int expected, chess::Bitboard occupied) {
+        EXPECT_EQ(expected, instance->findOccupancy(occupied));
+    }
+
+    void thenRepetitionsShouldBe(int expected) {
+        EXPECT_EQ(expected, instance->countRepetitions());
+    }
+
     void doPerftFor(int depth) {
         if (depth == 0) {
             nodes++;
@@ -33,6 +92,7 @@ class Chess0x88Test : public ::testing::Test {
                 continue;
             }
             doPerftFor(depth - 1);
+            instance->pop();
             instance->unmake_move(move);
         }
     }
@@ -47,6 +107,7 @@ class Chess0x88Test : public ::testing::Test {
   private:
     std::unique_ptr<Chess0x88> instance;
     long nodes = 0;
+    uint32_t foundMove = 0;
 };
 
 TEST_F(Chess0x88Test, getOccupiedSquaresForInitialPosition) {
@@ -100,3 +161,90 @@ TEST_F(Chess0x88Test, testPerft) {
     // Stalemate & Checkmate
     testPerft("8/8/2k5/5q2/5n2/8/5K2/8 b - - 0 1", 4, 23527);
 }
+
+TEST_F(Chess0x88Test, findMove) {
+    givenAnInstance();
+    whenFindingMove(52, 36, chess::pieces::Q); // e2e4
+    thenFoundMoveShouldBe(52, 36, chess::pieces::e);
+    thenPieceAtSquareShouldBe(6, 4, chess::pieces::P); // board is unchanged
+}
+
+TEST_F(Chess0x88Test, findMoveRejectsIllegalMove) {
+    givenAnInstance();
+    whenFindingMove(52, 28, chess::pieces::Q); // e2e5
+    thenNoMoveShouldBeFound();
+    givenPosition("4k3/8/8/8/8/8/4r3/4KB2 w - - 0 1");
+    whenFindingMove(61, 54, chess::pieces::Q); // Bg2 leaves the king in check
+    thenNoMoveShouldBeFound();
+    whenFindingMove(61, 52, chess::pieces::Q); // Bxe2
+    thenFoundMoveShouldBe(61, 52, chess::pieces::e);
+}
+
+TEST_F(Chess0x88Test, findMoveSelectsPromotionPiece) {
+    givenAnInstance();
+    givenPosition("8/P3k3/8/8/8/8/8/4K3 w - - 0 1");
+    whenFindingMove(8, 0, chess::pieces::N);
+    thenFoundMoveShouldBe(8, 0, chess::pieces::N);
+}
+
+TEST_F(Chess0x88Test, getOccupancyForInitialPosition) {
+    givenAnInstance();
+    thenOccupancyShouldBe(0xFFFF00000000FFFFULL);
+}
+
+TEST_F(Chess0x88Test, hashOfPlayedMovesEqualsHashOfPosition) {
+    givenAnInstance();
+    givenMovesAreMade({{52, 36}, {12, 28}, {62, 45}});
+    thenHashShouldBeHashOf("rnbqkbnr/pppp1ppp/8/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R b KQkq - 1 2");
+}
+
+TEST_F(Chess0x88Test, hashIsRestoredWhenMovesAreTakenBack) {
+    givenAnInstance();
+    givenPosition("r3k2r/8/8/3pP3/8/8/8/R3K2R w KQkq d6 0 1");
+    givenMovesAreMade({{28, 19}, {4, 6}, {60, 58}});
+    thenHashShouldBeHashOf("r4rk1/8/3P4/8/8/8/8/2KR3R b - - 1 2");
+    whenTakingBackMoves(3);
+    thenHashShouldBeHashOf("r3k2r/8/8/3pP3/8/8/8/R3K2R w KQkq d6 0 1");
+}
+
+TEST_F(Chess0x88Test, makeAndUnmakeRestorePositionWithoutEnPassantSquare) {
+    givenAnInstance();
+    givenPosition("4k3/8/8/8/8/8/1p6/4K3 b - - 0 1");
+    whenEachMoveIsMadeAndTakenBack();
+    whenEachMoveIsMadeAndTakenBack();
+    thenHashShouldBeHashOf("4k3/8/8/8/8/8/1p6/4K3 b - - 0 1");
+    thenPieceAtSquareShouldBe(6, 0, chess::pieces::e);
+    // b2 to the empty a1 must not become an en passant capture
+    whenFindingMove(49, 56, 0);
+    thenNoMoveShouldBeFound();
+}
+
+TEST_F(Chess0x88Test, makeAndUnmakeRestoreCastlingRightsAndEnPassantSquare) {
+    givenAnInstance();
+    givenPosition("r3k2r/8/8/3pP3/8/8/8/R3K2R w KQkq d6 0 1");
+    whenEachMoveIsMadeAndTakenBack();
+    thenHashShouldBeHashOf("r3k2r/8/8/3pP3/8/8/8/R3K2R w KQkq d6 0 1");
+    whenFindingMove(28, 19, 0);
+    thenFoundMoveShouldBe(28, 19, 0);
+}
+
+TEST_F(Chess0x88Test, findOccupancyOfEarlierPosition) {
+    givenAnInstance();
+    givenMovesAreMade({{52, 36}, {12, 28}, {62, 45}, {1, 18}});
+    thenMovesToTakeBackShouldBe(4, 0xFFFF00000000FFFFULL);
+    thenMovesToTakeBackShouldBe(2, 0xFFEF00101000EFFFULL);
+    thenMovesToTakeBackShouldBe(0, 0xFFFF000000000000ULL);
+    whenTakingBackMoves(2);
+    thenMovesToTakeBackShouldBe(0, 0xFFEF00101000EFFFULL);
+    thenMovesToTakeBackShouldBe(2, 0xFFFF00000000FFFFULL);
+}
+
+TEST_F(Chess0x88Test, countRepetitions) {
+    givenAnInstance();
+    givenMovesAreMade({{62, 45}, {6, 21}, {45, 62}});
+    thenRepetitionsShouldBe(0);
+    givenMovesAreMade({{21, 6}});
+    thenRepetitionsShouldBe(1);
+    givenMovesAreMade({{62, 45}, {6, 21}, {45, 62}, {21, 6}});
+    thenRepetitionsShouldBe(2);
+}
@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 
+#include "ChessData.h"
 #include "ChessnutAdapter.h"
 
 using ::testing::AtLeast;
@@ -55,11 +56,63 @@ class ChessnutAdapterTest : public ::testing::Test {
         }
     }
 
+    void givenStoredCalibration() {
+        adapter->setCalibrationStoreFunction([this](eboard::Stones const& stones) {
+            storedStones = stones;
+        });
+        givenCalibrationDataIsReceived();
+        SetUp();
+        adapter->restoreCalibration(storedStones);
+    }
+
+    void givenStoredCalibrationOfOtherPieces() {
+        storedStones.insert(eboard::CertaboPiece(eboard::PieceId{48, 0, 248, 71, 100}), eboard::ChessData::BLACK_ROOK);
+        adapter->restoreCalibration(storedStones);
+    }
+
+    void whenCalibrationPositionWithQueensIsReceived(int times) {
+        std::vector<uint8_t> data(boardDataWithQueens.begin(), boardDataWithQueens.end());
+        for (int i = 0; i < times; i++) {
+            adapter->fromUsb(&data.front(), data.size());
+        }
+    }
+
+    void givenHistoryDepth(size_t depth) {
+        adapter->setHistoryDepth(depth);
+    }
+
+    void givenConnectionInterval(int connectionIntervalMicros) {
+        adapter->setConnectionInterval(connectionIntervalMicros);
+    }
+
+    void whenPendingBoardIsSent() {
+        pendingMillis = adapter->sendPendingBoard();
+    }
+
+    void thenPendingBoardShouldBeDueIn(int minMillis, int maxMillis) {
+        EXPECT_GE(pendingMillis, minMillis);
+        EXPECT_LE(pendingMillis, maxMillis);
+    }
+
+    void thenAdapterShouldBeReady() {
+        EXPECT_TRUE(adapter->isReady());
+    }
+
+    void thenAdapterShouldNotBeReady() {
+        EXPECT_FALSE(adapter->isReady());
+    }
+
     void whenBoardDataWithoutQueensIsReceivedOnce() {
         std::vector<uint8_t> data(boardDataWithoutQueens.begin(), boardDataWithoutQueens.end());
         adapter->fromUsb(&data.front(), data.size());
     }
 
+    void whenBoardDataWithoutQueensIsReceived(int times) {
+        for (int i = 0; i < times; i++) {
+            whenBoardDataWithoutQueensIsReceivedOnce();
+        }
+    }
+
     void whenCalibrationPositionWithQueensIsReceivedOnce() {
         std::vector<uint8_t> data(boardDataWithQueens.begin(), boardDataWithQueens.end());
         adapter->fromUsb(&data.front(), data.size());
@@ -72,6 +125,18 @@ class ChessnutAdapterTest : public ::testing::Test {
                                        << "toBleData: " << toHex(converted.data(), converted.size());
     }
 
+    void whenRealTimeModeIsEnabledAgain() {
+        std::vector<uint8_t> uploadMode{0x21, 0x01, 0x01};
+        adapter->fromBle(&uploadMode.front(), uploadMode.size());
+        std::vector<uint8_t> realTimeMode{0x21, 0x01, 0x00};
+        adapter->fromBle(&realTimeMode.front(), realTimeMode.size());
+        toBleData.clear();
+    }
+
+    void givenToBleDataIsCleared() {
+        toBleData.clear();
+    }
+
     void thenToBleShouldNotBeCalled() {
         EXPECT_EQ(toBleData.size(), 0);
     }
@@ -79,6 +144,8 @@ class ChessnutAdapterTest : public ::testing::Test {
   private:
     std::unique_ptr<ChessnutAdapter> adapter;
     std::vector<uint8_t> toBleData;
+    eboard::Stones storedStones;
+    int pendingMillis = -1;
 
     static std::string toHex(unsigned const char* data, int len) {
         std::stringstream ss;
@@ -107,3 +174,82 @@ TEST_F(ChessnutAdapterTest, calibrationPositionFromUsb) {
     whenCalibrationPositionWithQueensIsReceivedOnce();
     thenToBleShouldNotBeCalled();
 }
+
+TEST_F(ChessnutAdapterTest, unchangedBoardIsNotSentAgain) {
+    givenCalibrationDataIsReceived();
+    whenBoardDataWithoutQueensIsReceivedOnce();
+    givenToBleDataIsCleared();
+    whenBoardDataWithoutQueensIsReceivedOnce();
+    thenToBleShouldNotBeCalled();
+}
+
+TEST_F(ChessnutAdapterTest, unchangedBoardIsSentAfterRealTimeModeIsEnabled) {
+    givenCalibrationDataIsReceived();
+    whenBoardDataWithoutQueensIsReceivedOnce();
+    whenRealTimeModeIsEnabledAgain();
+    whenBoardDataWithoutQueensIsReceivedOnce();
+    thenToBleShouldBeCalledStartingWith({0x01, 0x24});
+}
+
+TEST_F(ChessnutAdapterTest, storedCalibrationIsRestored) {
+    givenStoredCalibration();
+    // the first board only tells that the board has piece recognition
+    whenCalibrationPositionWithQueensIsReceived(2);
+    thenAdapterShouldBeReady();
+    whenBoardDataWithoutQueensIsReceivedOnce();
+    thenToBleShouldBeCalledStartingWith({0x01, 0x24, 0x58, 0x23, 0x31, 0x85});
+}
+
+TEST_F(ChessnutAdapterTest, storedCalibrationOfOtherPiecesIsIgnored) {
+    givenStoredCalibrationOfOtherPieces();
+    whenCalibrationPositionWithQueensIsReceived(2);
+    thenAdapterShouldNotBeReady();
+}
+
+TEST_F(ChessnutAdapterTest, changedBoardIsSentAfterOneFrameWithHistoryDepthOne) {
+    givenHistoryDepth(1);
+    givenCalibrationDataIsReceived();
+    whenCalibrationPositionWithQueensIsReceived(3);
+    givenToBleDataIsCleared();
+    whenBoardDataWithoutQueensIsReceivedOnce();
+    thenToBleShouldBeCalledStartingWith({0x01, 0x24});
+}
+
+TEST_F(ChessnutAdapterTest, changedBoardIsSentOncePerConnectionInterval) {
+    givenCalibrationDataIsReceived();
+    givenConnectionInterval(100000);
+    whenBoardDataWithoutQueensIsReceivedOnce();
+    givenToBleDataIsCleared();
+    whenCalibrationPositionWithQueensIsReceived(3);
+    thenToBleShouldNotBeCalled();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    whenCalibrationPositionWithQueensIsReceivedOnce();
+    thenToBleShouldBeCalledStartingWith({0x01, 0x24});
+}
+
+TEST_F(ChessnutAdapterTest, changedBoardWithinConnectionIntervalIsSentWhenIntervalHasPassed) {
+    givenCalibrationDataIsReceived();
+    givenConnectionInterval(100000);
+    whenBoardDataWithoutQueensIsReceivedOnce();
+    givenToBleDataIsCleared();
+    whenCalibrationPositionWithQueensIsReceived(3);
+    whenPendingBoardIsSent();
+    thenToBleShouldNotBeCalled();
+    thenPendingBoardShouldBeDueIn(1, 100);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    whenPendingBoardIsSent();
+    thenToBleShouldBeCalledStartingWith({0x01, 0x24});
+    thenPendingBoardShouldBeDueIn(-1, -1);
+}
+
+TEST_F(ChessnutAdapterTest, boardChangedBackWithinConnectionIntervalIsNotPending) {
+    givenCalibrationDataIsReceived();
+    givenConnectionInterval(100000);
+    whenBoardDataWithoutQueensIsReceivedOnce();
+    givenToBleDataIsCleared();
+    whenCalibrationPositionWithQueensIsReceived(3);
+    whenBoardDataWithoutQueensIsReceived(3);
+    whenPendingBoardIsSent();
+    thenPendingBoardShouldBeDueIn(-1, -1);
+    thenToBleShouldNotBeCalled();
+}
@@ -26,7 +26,12 @@ class ChessnutConverterTest : public ::testing::Test {
     }
 
     void whenChessnutToCertaboCommandIsCalledWith(std::vector<uint8_t> data) {
-        convertedCommand = converter->chessnutToCertaboCommand(&data.front(), data.size());
+        eboard::LedCommand ledCommand;
+        if (converter->chessnutToCertaboCommand(&data.front(), data.size(), ledCommand)) {
+            convertedCommand.assign(ledCommand.begin(), ledCommand.end());
+        } else {
+            convertedCommand.clear();
+        }
     }
 
     void thenInfoCallbackShouldBeCalledWith(std::vector<uint8_t> const& expected) {
@@ -99,6 +104,34 @@ TEST_F(ChessnutConverterTest, convertInitialPosition) {
     thenSizeOfBoardCallbackShouldBe(38);
 }
 
+TEST_F(ChessnutConverterTest, convertChangedSquaresOnly) {
+    std::array<eboard::StoneId, 64> board{
+        2,   3,   4,   5,   6,   4,   3,   2,   //
+        1,   1,   1,   1,   1,   1,   1,   1,   //
+        0,   0,   0,   0,   0,   0,   0,   0,   //
+        0,   0,   0,   0,   0,   0,   0,   0,   //
+        0,   0,   0,   0,   0,   0,   0,   0,   //
+        0,   0,   0,   0,   0,   0,   0,   0,   //
+        129, 129, 129, 129, 129, 129, 129, 129, //
+        130, 131, 132, 133, 134, 132, 131, 130};
+    whenConvertingBoard(board);
+    board[12] = 0; // e2-e4
+    board[28] = 1;
+    whenConvertingBoard(board);
+    board[52] = 0; // e7-e5
+    board[36] = 129;
+    whenConvertingBoard(board);
+    std::vector<uint8_t> expected{
+        0x01, 0x24,                                     //
+        0x58, 0x23, 0x31, 0x85, 0x44, 0x04, 0x44, 0x44, //
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, //
+        0x00, 0x70, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, //
+        0x77, 0x07, 0x77, 0x77, 0xA6, 0xC9, 0x9B, 0x6A, //
+    };
+    thenBoardCallbackShouldBeCalledStartingWith(expected);
+    thenSizeOfBoardCallbackShouldBe(38);
+}
+
 TEST_F(ChessnutConverterTest, realTimeMode) {
     whenChessnutToCertaboCommandIsCalledWith({0x21, 0x01, 0x00});
     thenInfoCallbackShouldBeCalledWith({0x23, 0x01, 0x00}); // ack
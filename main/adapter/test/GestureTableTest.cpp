@@ -0,0 +1,54 @@
+#include <gmock/gmock.h>
+
+#include "GestureTable.h"
+
+using eboard::Gesture;
+using eboard::GestureAction;
+using eboard::GestureTable;
+using eboard::StoneId;
+
+class GestureTableTest : public ::testing::Test {
+  protected:
+    static std::array<StoneId, 64> board(int square, StoneId stone) {
+        std::array<StoneId, 64> result{};
+        result[square] = stone;
+        return result;
+    }
+
+    void givenGestures() {
+        for (int square = 0; square < 8; square++) {
+            positions[square] = board(16 + square, 6);
+            table.add(positions[square], GestureAction::BRIGHTNESS, square);
+        }
+    }
+
+    Gesture const* whenLookingUp(std::array<StoneId, 64> const& position) const {
+        return table.find(position);
+    }
+
+  private:
+    std::array<std::array<StoneId, 64>, 8> positions{};
+    GestureTable table;
+};
+
+TEST_F(GestureTableTest, specialPositionIsFound) {
+    givenGestures();
+    for (int square = 0; square < 8; square++) {
+        Gesture const* gesture = whenLookingUp(board(16 + square, 6));
+        ASSERT_NE(nullptr, gesture);
+        EXPECT_EQ(GestureAction::BRIGHTNESS, gesture->action);
+        EXPECT_EQ(square, gesture->value);
+    }
+}
+
+TEST_F(GestureTableTest, otherPositionIsNotFound) {
+    givenGestures();
+    EXPECT_EQ(nullptr, whenLookingUp(board(24, 6)));
+    EXPECT_EQ(nullptr, whenLookingUp(board(16, 5)));
+}
+
+TEST_F(GestureTableTest, fingerprintDependsOnAllSquares) {
+    for (int square = 0; square < 64; square++) {
+        EXPECT_NE(GestureTable::fingerprint(board(square, 0)), GestureTable::fingerprint(board(square, 1)));
+    }
+}
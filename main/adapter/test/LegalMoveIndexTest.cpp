@@ -0,0 +1,111 @@
+#include <gmock/gmock.h>
+
+#include <string>
+
+#include "Chess0x88.h"
+#include "LegalMoveIndex.h"
+
+using chess::Bitboard;
+using chess::Chess0x88;
+using chess::LegalMoveIndex;
+using chess::squareMask;
+
+class LegalMoveIndexTest : public ::testing::Test {
+  protected:
+    void givenPosition(std::string const& fen) {
+        board.parse_fen(fen.c_str());
+    }
+
+    void whenBuildingTheIndex() {
+        index.build(board);
+    }
+
+    void thenIndexSizeShouldBe(size_t expected) {
+        EXPECT_EQ(expected, index.size());
+        EXPECT_EQ(board.getHash(), index.getHash());
+    }
+
+    void thenMoveShouldBe(int fromSquare, int toSquare, Bitboard occupied, Bitboard lifted,
+                          int promotedPiece = chess::Q) {
+        uint32_t move = index.find(occupied, lifted, promotedPiece);
+        ASSERT_NE(0, move);
+        EXPECT_EQ(fromSquare, get_move_source_64(move));
+        EXPECT_EQ(toSquare, get_move_target_64(move));
+        if (get_move_piece(move)) {
+            EXPECT_EQ(promotedPiece, get_move_piece(move));
+        }
+    }
+
+    void thenNoMoveShouldBeFound(Bitboard occupied, Bitboard lifted) {
+        EXPECT_EQ(0, index.find(occupied, lifted, chess::Q));
+    }
+
+    static Bitboard moved(Bitboard occupied, int fromSquare, int toSquare) {
+        return (occupied & ~squareMask(fromSquare)) | squareMask(toSquare);
+    }
+
+    Chess0x88 board;
+    LegalMoveIndex index;
+};
+
+TEST_F(LegalMoveIndexTest, initialPosition) {
+    whenBuildingTheIndex();
+    thenIndexSizeShouldBe(20);
+    Bitboard initial = board.getOccupancy();
+    thenMoveShouldBe(52, 36, moved(initial, 52, 36), squareMask(52));
+    thenMoveShouldBe(62, 45, moved(initial, 62, 45), squareMask(62));
+    thenNoMoveShouldBeFound(moved(initial, 52, 36), 0);
+    thenNoMoveShouldBeFound(moved(initial, 52, 28), squareMask(52));
+}
+
+TEST_F(LegalMoveIndexTest, buildingLeavesTheBoardUnchanged) {
+    givenPosition("4k3/8/8/8/8/8/1p6/4K3 b - - 0 1");
+    uint64_t hash = board.getHash();
+    whenBuildingTheIndex();
+    whenBuildingTheIndex();
+    thenIndexSizeShouldBe(9);
+    EXPECT_EQ(hash, board.getHash());
+    EXPECT_EQ(chess::e, board.getPiece(6, 0));
+}
+
+TEST_F(LegalMoveIndexTest, captureNeedsTheCapturedPieceToBeLifted) {
+    // 1. e4 d5
+    givenPosition("rnbqkbnr/ppp1pppp/8/3p4/4P3/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 2");
+    whenBuildingTheIndex();
+    Bitboard afterCapture = board.getOccupancy() & ~squareMask(36);
+    thenNoMoveShouldBeFound(afterCapture, squareMask(36));
+    thenMoveShouldBe(36, 27, afterCapture, squareMask(36) | squareMask(27));
+}
+
+TEST_F(LegalMoveIndexTest, castlingNeedsBothPiecesToBeMoved) {
+    givenPosition("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1");
+    whenBuildingTheIndex();
+    Bitboard kingMoved = moved(board.getOccupancy(), 60, 62);
+    thenNoMoveShouldBeFound(kingMoved, squareMask(60));
+    thenMoveShouldBe(60, 62, moved(kingMoved, 63, 61), squareMask(60) | squareMask(63));
+}
+
+TEST_F(LegalMoveIndexTest, enPassantCapture) {
+    givenPosition("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3");
+    whenBuildingTheIndex();
+    Bitboard afterCapture = moved(board.getOccupancy(), 28, 21) & ~squareMask(29);
+    thenNoMoveShouldBeFound(afterCapture, squareMask(28));
+    thenMoveShouldBe(28, 21, afterCapture, squareMask(28) | squareMask(29));
+}
+
+TEST_F(LegalMoveIndexTest, promotionToPreferredPiece) {
+    givenPosition("8/1P6/8/8/8/8/8/k1K5 w - - 0 1");
+    whenBuildingTheIndex();
+    Bitboard promoted = moved(board.getOccupancy(), 9, 1);
+    thenMoveShouldBe(9, 1, promoted, squareMask(9), chess::Q);
+    thenMoveShouldBe(9, 1, promoted, squareMask(9), chess::N);
+}
+
+TEST_F(LegalMoveIndexTest, ambiguousCaptureIsNotResolved) {
+    // the knight on f3 can capture on e5 and d4
+    givenPosition("4k3/8/8/4p3/3p4/5N2/8/4K3 w - - 0 1");
+    whenBuildingTheIndex();
+    Bitboard afterCapture = board.getOccupancy() & ~squareMask(45);
+    thenMoveShouldBe(45, 28, afterCapture, squareMask(45) | squareMask(28));
+    thenNoMoveShouldBeFound(afterCapture, squareMask(45) | squareMask(28) | squareMask(35));
+}
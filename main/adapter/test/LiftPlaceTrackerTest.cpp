@@ -0,0 +1,62 @@
+#include <gmock/gmock.h>
+
+#include <utility>
+#include <vector>
+
+#include "LiftPlaceTracker.h"
+
+using chess::Bitboard;
+using chess::squareMask;
+using eboard::LiftPlaceTracker;
+using eboard::PieceEvent;
+
+class LiftPlaceTrackerTest : public ::testing::Test {
+  protected:
+    void givenOccupancy(Bitboard occupied) {
+        tracker.update(occupied);
+        PieceEvent event{};
+        while (tracker.nextEvent(event)) {
+        }
+    }
+
+    void whenOccupancyIs(Bitboard occupied) {
+        tracker.update(occupied);
+    }
+
+    void thenEventsShouldBe(std::vector<std::pair<PieceEvent::Type, int>> const& expected) {
+        std::vector<std::pair<PieceEvent::Type, int>> events;
+        PieceEvent event{};
+        while (tracker.nextEvent(event)) {
+            events.emplace_back(event.type, event.square);
+        }
+        EXPECT_EQ(expected, events);
+    }
+
+    LiftPlaceTracker tracker;
+};
+
+TEST_F(LiftPlaceTrackerTest, firstUpdatePlacesAllPieces) {
+    whenOccupancyIs(squareMask(0) | squareMask(63));
+    thenEventsShouldBe({{PieceEvent::PLACE, 0}, {PieceEvent::PLACE, 63}});
+}
+
+TEST_F(LiftPlaceTrackerTest, moveIsLiftAndPlace) {
+    givenOccupancy(0xFFFF00000000FFFFULL);
+    whenOccupancyIs(0xFFFF00000000FFFFULL & ~squareMask(52));
+    whenOccupancyIs((0xFFFF00000000FFFFULL & ~squareMask(52)) | squareMask(36));
+    thenEventsShouldBe({{PieceEvent::LIFT, 52}, {PieceEvent::PLACE, 36}});
+}
+
+TEST_F(LiftPlaceTrackerTest, unchangedOccupancyQueuesNothing) {
+    givenOccupancy(0xFFFF00000000FFFFULL);
+    whenOccupancyIs(0xFFFF00000000FFFFULL);
+    thenEventsShouldBe({});
+    EXPECT_EQ(0, tracker.pending());
+}
+
+TEST_F(LiftPlaceTrackerTest, eventsBeyondCapacityAreDropped) {
+    whenOccupancyIs(~Bitboard{0});
+    whenOccupancyIs(0);
+    EXPECT_EQ(size_t{LiftPlaceTracker::CAPACITY}, tracker.pending());
+    EXPECT_EQ(64, tracker.dropped());
+}
@@ -0,0 +1,60 @@
+#include <gmock/gmock.h>
+
+#include "ChessData.h"
+#include "MajorityFilter.h"
+
+using eboard::ChessData;
+using eboard::MajorityFilter;
+using eboard::StoneId;
+
+class MajorityFilterTest : public ::testing::Test {
+  protected:
+    static std::array<StoneId, 64> board(StoneId e2) {
+        std::array<StoneId, 64> result{};
+        result[12] = e2;
+        return result;
+    }
+
+    StoneId whenBoardIsFiltered(StoneId e2) {
+        return filter.filter(board(e2))[12];
+    }
+
+    MajorityFilter filter;
+};
+
+TEST_F(MajorityFilterTest, singleBoardIsPassedThrough) {
+    EXPECT_EQ(StoneId{ChessData::WHITE_PAWN}, whenBoardIsFiltered(ChessData::WHITE_PAWN));
+}
+
+TEST_F(MajorityFilterTest, singleWrongReadingIsIgnored) {
+    whenBoardIsFiltered(ChessData::WHITE_PAWN);
+    whenBoardIsFiltered(ChessData::WHITE_PAWN);
+    EXPECT_EQ(StoneId{ChessData::WHITE_PAWN}, whenBoardIsFiltered(ChessData::BLACK_PAWN));
+    whenBoardIsFiltered(ChessData::WHITE_PAWN);
+    whenBoardIsFiltered(ChessData::WHITE_PAWN);
+    EXPECT_EQ(StoneId{ChessData::WHITE_PAWN}, whenBoardIsFiltered(ChessData::NO_STONE));
+    EXPECT_EQ(StoneId{ChessData::NO_STONE}, whenBoardIsFiltered(ChessData::NO_STONE));
+}
+
+TEST_F(MajorityFilterTest, newestBoardWinsWithoutMajority) {
+    whenBoardIsFiltered(ChessData::WHITE_PAWN);
+    whenBoardIsFiltered(ChessData::BLACK_PAWN);
+    EXPECT_EQ(StoneId{ChessData::WHITE_QUEEN}, whenBoardIsFiltered(ChessData::WHITE_QUEEN));
+}
+
+TEST_F(MajorityFilterTest, deeperHistoryRejectsMoreNoise) {
+    filter.setDepth(5);
+    for (int i = 0; i < 5; i++) {
+        whenBoardIsFiltered(ChessData::WHITE_PAWN);
+    }
+    EXPECT_EQ(StoneId{ChessData::WHITE_PAWN}, whenBoardIsFiltered(ChessData::NO_STONE));
+    EXPECT_EQ(StoneId{ChessData::WHITE_PAWN}, whenBoardIsFiltered(ChessData::NO_STONE));
+    EXPECT_EQ(StoneId{ChessData::NO_STONE}, whenBoardIsFiltered(ChessData::NO_STONE));
+}
+
+TEST_F(MajorityFilterTest, depthIsLimited) {
+    filter.setDepth(0);
+    EXPECT_EQ(1, filter.getDepth());
+    filter.setDepth(100);
+    EXPECT_EQ(size_t{MajorityFilter::MAX_DEPTH}, filter.getDepth());
+}
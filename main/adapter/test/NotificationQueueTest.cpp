@@ -0,0 +1,132 @@
+#include <gmock/gmock.h>
+
+#include <functional>
+
+#include "NotificationQueue.h"
+
+using eboard::NotificationCounters;
+using eboard::NotificationQueue;
+using eboard::NotifyResult;
+
+class NotificationQueueTest : public ::testing::Test {
+  protected:
+    void givenNotifyResult(NotifyResult result) {
+        notifyResult = result;
+    }
+
+    void whenSendingBoard(uint8_t value) {
+        std::vector<uint8_t> board(NotificationQueue::MAX_NOTIFICATION_SIZE, value);
+        board[0] = 0x01;
+        queue.send(board.data(), board.size(), true);
+    }
+
+    void whenSendingAck() {
+        std::vector<uint8_t> ack{0x23, 0x01, 0x00};
+        queue.send(ack.data(), ack.size(), false);
+    }
+
+    void whenBuffersAreAvailableAgain() {
+        notifyResult = NotifyResult::SENT;
+        queue.flush();
+    }
+
+    void givenWhileNotifying(std::function<void()> callback) {
+        whileNotifying = std::move(callback);
+    }
+
+    void whenFlushing() {
+        queue.flush();
+    }
+
+    void whenClearing() {
+        queue.clear();
+    }
+
+    void thenSentShouldBe(std::vector<uint8_t> const& expectedFirstBytes) {
+        EXPECT_EQ(expectedFirstBytes, sentFirstBytes);
+    }
+
+    NotificationCounters counters() const {
+        return queue.getCounters();
+    }
+
+  private:
+    NotifyResult notifyResult = NotifyResult::SENT;
+    /** first byte of acks, last byte of boards */
+    std::vector<uint8_t> sentFirstBytes;
+    /** called once from the next notify, like a BLE event raised while notifying */
+    std::function<void()> whileNotifying;
+    NotificationQueue queue{[this](const uint8_t* data, size_t data_len, bool isBoardData) {
+        if (whileNotifying) {
+            std::function<void()> callback = std::move(whileNotifying);
+            whileNotifying = nullptr;
+            callback();
+        }
+        if (notifyResult == NotifyResult::SENT) {
+            sentFirstBytes.push_back(isBoardData ? data[data_len - 1] : data[0]);
+        }
+        return notifyResult;
+    }};
+};
+
+TEST_F(NotificationQueueTest, notificationIsSentImmediately) {
+    whenSendingBoard(7);
+    whenSendingAck();
+    thenSentShouldBe({7, 0x23});
+    EXPECT_EQ(2, counters().sent);
+}
+
+TEST_F(NotificationQueueTest, queuedBoardsAreCollapsedButAcksAreKept) {
+    givenNotifyResult(NotifyResult::NO_BUFFER);
+    whenSendingBoard(1);
+    whenSendingAck();
+    whenSendingBoard(2);
+    whenSendingBoard(3);
+    thenSentShouldBe({});
+    whenBuffersAreAvailableAgain();
+    thenSentShouldBe({3, 0x23});
+    EXPECT_EQ(2, counters().boardsCollapsed);
+    EXPECT_EQ(4, counters().noBuffer);
+}
+
+TEST_F(NotificationQueueTest, failedNotificationIsDropped) {
+    givenNotifyResult(NotifyResult::FAILED);
+    whenSendingAck();
+    whenBuffersAreAvailableAgain();
+    thenSentShouldBe({});
+    EXPECT_EQ(1, counters().failed);
+}
+
+TEST_F(NotificationQueueTest, fullQueueRejectsNotifications) {
+    givenNotifyResult(NotifyResult::NO_BUFFER);
+    for (size_t i = 0; i <= NotificationQueue::CAPACITY; i++) {
+        whenSendingAck();
+    }
+    EXPECT_EQ(1, counters().overflows);
+    whenBuffersAreAvailableAgain();
+    EXPECT_EQ(size_t{NotificationQueue::CAPACITY}, counters().sent);
+}
+
+TEST_F(NotificationQueueTest, flushWhileNotifyingReturnsAtOnce) {
+    givenWhileNotifying([this]() { whenFlushing(); });
+    whenSendingAck();
+    thenSentShouldBe({0x23});
+    EXPECT_EQ(1, counters().sent);
+}
+
+TEST_F(NotificationQueueTest, boardSentWhileNotifyingABoardIsSentAfterIt) {
+    givenWhileNotifying([this]() { whenSendingBoard(2); });
+    whenSendingBoard(1);
+    thenSentShouldBe({1, 2});
+    EXPECT_EQ(0, counters().boardsCollapsed);
+}
+
+TEST_F(NotificationQueueTest, clearWhileNotifyingKeepsLaterNotifications) {
+    givenWhileNotifying([this]() {
+        whenClearing();
+        whenSendingBoard(2);
+    });
+    whenSendingAck();
+    thenSentShouldBe({0x23, 2});
+    EXPECT_EQ(2, counters().sent);
+}
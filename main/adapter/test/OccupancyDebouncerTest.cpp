@@ -0,0 +1,95 @@
+#include <gmock/gmock.h>
+
+#include "OccupancyDebouncer.h"
+
+using chess::Bitboard;
+using eboard::DebounceSettings;
+using eboard::OccupancyDebouncer;
+
+class OccupancyDebouncerTest : public ::testing::Test {
+  protected:
+    void givenFramesEvery(uint32_t intervalMs, size_t count, Bitboard occupied) {
+        for (size_t i = 0; i < count; i++) {
+            whenFrameIsReceived(occupied);
+            nowMs += intervalMs;
+        }
+    }
+
+    void whenFrameIsReceived(Bitboard occupied) {
+        stable = debouncer.update(occupied, nowMs);
+    }
+
+    void whenTimePasses(uint32_t ms) {
+        nowMs += ms;
+    }
+
+    void thenOccupancyShouldBeStable(bool expected) {
+        EXPECT_EQ(expected, stable);
+    }
+
+    OccupancyDebouncer debouncer;
+    uint64_t nowMs = 1000;
+    bool stable = false;
+};
+
+TEST_F(OccupancyDebouncerTest, minimumFramesWithoutKnownFrameRate) {
+    whenFrameIsReceived(1);
+    thenOccupancyShouldBeStable(false);
+    whenFrameIsReceived(1);
+    thenOccupancyShouldBeStable(true);
+}
+
+TEST_F(OccupancyDebouncerTest, changedOccupancyStartsOver) {
+    givenFramesEvery(50, 4, 1);
+    whenFrameIsReceived(3);
+    thenOccupancyShouldBeStable(false);
+}
+
+TEST_F(OccupancyDebouncerTest, consecutiveFramesAreCounted) {
+    givenFramesEvery(50, 3, 1);
+    EXPECT_EQ(3, debouncer.getConsecutiveFrames());
+    whenFrameIsReceived(3);
+    EXPECT_EQ(1, debouncer.getConsecutiveFrames());
+}
+
+TEST_F(OccupancyDebouncerTest, framesAreLearnedFromFrameRate) {
+    givenFramesEvery(20, 10, 1);
+    EXPECT_EQ(20, debouncer.getFrameIntervalMs());
+    EXPECT_EQ(5, debouncer.getStableFrames());
+    EXPECT_EQ(150, debouncer.getStableTimeMs());
+    givenFramesEvery(20, 4, 3);
+    whenFrameIsReceived(3);
+    thenOccupancyShouldBeStable(true);
+}
+
+TEST_F(OccupancyDebouncerTest, slowBoardNeedsFewerFrames) {
+    givenFramesEvery(150, 10, 1);
+    EXPECT_EQ(2, debouncer.getStableFrames());
+    EXPECT_EQ(300, debouncer.getStableTimeMs());
+}
+
+TEST_F(OccupancyDebouncerTest, stableTimeCoversMissedFrames) {
+    givenFramesEvery(20, 10, 1);
+    whenFrameIsReceived(3);
+    whenTimePasses(200);
+    whenFrameIsReceived(3);
+    thenOccupancyShouldBeStable(true);
+}
+
+TEST_F(OccupancyDebouncerTest, pausesAreNotLearned) {
+    givenFramesEvery(20, 10, 1);
+    whenTimePasses(5000);
+    whenFrameIsReceived(1);
+    EXPECT_EQ(20, debouncer.getFrameIntervalMs());
+}
+
+TEST_F(OccupancyDebouncerTest, settingsAreClamped) {
+    DebounceSettings settings;
+    settings.minFrames = 0;
+    settings.maxFrames = 0;
+    debouncer.setSettings(settings);
+    EXPECT_EQ(1, debouncer.getSettings().minFrames);
+    EXPECT_EQ(1, debouncer.getSettings().maxFrames);
+    whenFrameIsReceived(1);
+    thenOccupancyShouldBeStable(true);
+}
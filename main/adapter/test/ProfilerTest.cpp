@@ -0,0 +1,101 @@
+#include <gmock/gmock.h>
+
+#include "Profiler.h"
+
+using eboard::LatencyHistogram;
+using eboard::ProfileStage;
+using eboard::Profiler;
+
+class ProfilerTest : public ::testing::Test {
+  protected:
+    void TearDown() override {
+        Profiler::install(nullptr);
+    }
+
+    void givenStageAt(ProfileStage stage, uint64_t micros) {
+        nowMicros = micros;
+        Profiler::mark(stage);
+    }
+
+    void givenFrameWithStagesAt(uint64_t rx, uint64_t parsed, uint64_t translated, uint64_t encoded,
+                                uint64_t notified) {
+        givenStageAt(ProfileStage::USB_RX, rx);
+        givenStageAt(ProfileStage::PARSED, parsed);
+        givenStageAt(ProfileStage::TRANSLATED, translated);
+        givenStageAt(ProfileStage::ENCODED, encoded);
+        givenStageAt(ProfileStage::NOTIFIED, notified);
+    }
+
+    void thenCountShouldBe(ProfileStage stage, size_t expected) {
+        EXPECT_EQ(expected, profiler.getHistogram(stage).getCount());
+    }
+
+    void thenMaxShouldBe(ProfileStage stage, uint64_t expected) {
+        EXPECT_EQ(expected, profiler.getHistogram(stage).getMaxMicros());
+    }
+
+    uint64_t nowMicros = 0;
+    Profiler profiler{[this]() {
+        return nowMicros;
+    }};
+};
+
+TEST_F(ProfilerTest, marksWithoutInstalledProfilerAreIgnored) {
+    givenFrameWithStagesAt(1000, 1200, 1300, 1400, 1500);
+    thenCountShouldBe(ProfileStage::USB_RX, 0);
+    thenCountShouldBe(ProfileStage::PARSED, 0);
+}
+
+TEST_F(ProfilerTest, stageLatenciesAndEndToEnd) {
+    Profiler::install(&profiler);
+    givenFrameWithStagesAt(1000, 1200, 1300, 1400, 3000);
+    thenMaxShouldBe(ProfileStage::PARSED, 200);
+    thenMaxShouldBe(ProfileStage::TRANSLATED, 100);
+    thenMaxShouldBe(ProfileStage::ENCODED, 100);
+    thenMaxShouldBe(ProfileStage::NOTIFIED, 1600);
+    thenMaxShouldBe(ProfileStage::USB_RX, 2000);
+}
+
+TEST_F(ProfilerTest, frameStartsWithFirstUsbTransfer) {
+    Profiler::install(&profiler);
+    givenStageAt(ProfileStage::USB_RX, 1000);
+    givenStageAt(ProfileStage::USB_RX, 1100);
+    givenStageAt(ProfileStage::PARSED, 1300);
+    givenStageAt(ProfileStage::USB_RX, 1400);
+    givenStageAt(ProfileStage::PARSED, 1500);
+    thenMaxShouldBe(ProfileStage::PARSED, 300);
+    thenCountShouldBe(ProfileStage::PARSED, 2);
+}
+
+TEST_F(ProfilerTest, stageWithoutPreviousStageIsNotMeasured) {
+    Profiler::install(&profiler);
+    // an unchanged board is parsed and translated but not encoded
+    givenStageAt(ProfileStage::USB_RX, 1000);
+    givenStageAt(ProfileStage::PARSED, 1100);
+    givenStageAt(ProfileStage::TRANSLATED, 1200);
+    givenStageAt(ProfileStage::NOTIFIED, 1300);
+    thenCountShouldBe(ProfileStage::TRANSLATED, 1);
+    thenCountShouldBe(ProfileStage::NOTIFIED, 0);
+    thenCountShouldBe(ProfileStage::USB_RX, 0);
+}
+
+TEST_F(ProfilerTest, resetClearsHistograms) {
+    Profiler::install(&profiler);
+    givenFrameWithStagesAt(1000, 1200, 1300, 1400, 1500);
+    profiler.reset();
+    thenCountShouldBe(ProfileStage::USB_RX, 0);
+    EXPECT_NE(std::string::npos, profiler.report().find("usb to ble: count 0"));
+}
+
+TEST_F(ProfilerTest, histogramBuckets) {
+    LatencyHistogram histogram;
+    histogram.add(100);
+    histogram.add(128);
+    histogram.add(255);
+    histogram.add(1000000000);
+    EXPECT_EQ(1, histogram.getBucketCount(0));
+    EXPECT_EQ(2, histogram.getBucketCount(1));
+    EXPECT_EQ(1, histogram.getBucketCount(LatencyHistogram::BUCKETS - 1));
+    EXPECT_EQ(256, histogram.getPercentileMicros(50));
+    EXPECT_EQ(1000000000, histogram.getPercentileMicros(100));
+}
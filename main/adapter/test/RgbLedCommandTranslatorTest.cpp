@@ -6,13 +6,39 @@
 
 #include "RgbLedCommandTranslator.h"
 
+using eboard::LedRole;
+using eboard::Rgb;
 using eboard::RgbLedCommandTranslator;
 
 class RgbLedCommandTranslatorTest : public ::testing::Test {
   protected:
-    void whenTranslating(std::vector<uint8_t> const& command) {
-        translatedCommand = translator.translate(command);
+    void whenTranslating(eboard::LedCommand const& command) {
+        frameChanged = translator.translate(command);
+        translatedCommand.assign(translator.getFrame().begin(), translator.getFrame().end());
     }
+
+    void whenSettingRoles(std::vector<std::pair<int, LedRole>> const& roles) {
+        for (auto const& role : roles) {
+            translator.setSquareRole(role.first, role.second);
+        }
+        frameChanged = translator.update();
+        translatedCommand.assign(translator.getFrame().begin(), translator.getFrame().end());
+    }
+
+    void givenBrightness(int brightness) {
+        translator.setBrightness(brightness);
+    }
+
+    void thenFrameShouldHaveChanged(bool expected) {
+        EXPECT_EQ(expected, frameChanged);
+    }
+
+    void thenLedShouldBe(int row, int col, Rgb expected) {
+        size_t index = 2 + (row * 9 + col) * 3;
+        EXPECT_EQ(expected, (Rgb{translatedCommand[index], translatedCommand[index + 1], translatedCommand[index + 2]}))
+            << "LED at row " << row << ", column " << col;
+    }
+
     void thenTranslatedCommandShouldBe(std::vector<uint8_t> const& expected) {
         EXPECT_EQ(translatedCommand, expected)
             << "expected: " << toHex(expected.data(), expected.size()) << std::endl
@@ -31,6 +57,7 @@ class RgbLedCommandTranslatorTest : public ::testing::Test {
 
     RgbLedCommandTranslator translator;
     std::vector<uint8_t> translatedCommand;
+    bool frameChanged = false;
 };
 
 TEST_F(RgbLedCommandTranslatorTest, translateLedsOffCommand) {
@@ -92,3 +119,30 @@ TEST_F(RgbLedCommandTranslatorTest, translateE2E4) {
         0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0d, 0x0a};
     thenTranslatedCommandShouldBe(expected);
 }
+
+TEST_F(RgbLedCommandTranslatorTest, unchangedCommandDoesNotChangeFrame) {
+    whenTranslating({0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x10, 0x00});
+    thenFrameShouldHaveChanged(true);
+    whenTranslating({0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x10, 0x00});
+    thenFrameShouldHaveChanged(false);
+    givenBrightness(0x80);
+    whenTranslating({0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x10, 0x00});
+    thenFrameShouldHaveChanged(true);
+}
+
+TEST_F(RgbLedCommandTranslatorTest, firstFrameIsAlwaysSent) {
+    whenTranslating({0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00});
+    thenFrameShouldHaveChanged(true);
+}
+
+TEST_F(RgbLedCommandTranslatorTest, rolesHaveDistinctColors) {
+    // squares are numbered like the bits of a Chessnut LED command: e2, e4, e1 and c2
+    whenSettingRoles({{52, LedRole::FROM}, {36, LedRole::TO}, {60, LedRole::CHECK}, {54, LedRole::HINT}});
+    thenFrameShouldHaveChanged(true);
+    thenLedShouldBe(2, 3, Rgb{0, 0x40, 0});
+    thenLedShouldBe(3, 3, Rgb{0, 0, 0x40});
+    thenLedShouldBe(0, 3, Rgb{0x40, 0, 0});
+    thenLedShouldBe(2, 1, Rgb{0x40, 0x40, 0});
+    whenSettingRoles({{52, LedRole::FROM}});
+    thenFrameShouldHaveChanged(false);
+}
@@ -44,9 +44,18 @@ class SentioTest : public ::testing::Test {
         whenCallingOccupiedSquaresWith(fenToOccupied(shortFen));
     }
 
-    void whenCallingOccupiedSquaresWith(std::array<bool, 64> const& occupied) {
-        instance->occupiedSquares(occupied);
-        std::this_thread::sleep_for(std::chrono::milliseconds(Sentio::MIN_TIME_TO_PROCESS_MS));
+    void whenOccupiedIsCalledWithoutDelay(std::string const& shortFen, size_t frames = MOVE_FRAMES) {
+        for (size_t frame = 0; frame < frames; frame++) {
+            instance->occupiedSquares(fenToOccupied(shortFen));
+        }
+    }
+
+    void whenCallingOccupiedSquaresWith(chess::Bitboard occupied) {
+        // the board sends its occupancy continuously, it is processed once it is stable
+        for (size_t frame = 0; frame < FRAMES_PER_OCCUPANCY; frame++) {
+            instance->occupiedSquares(occupied);
+            std::this_thread::sleep_for(std::chrono::milliseconds(FRAME_INTERVAL_MS));
+        }
     }
 
     void thenLastReceivedBoardShouldBe(std::string const& expectedBoard) {
@@ -57,15 +66,11 @@ class SentioTest : public ::testing::Test {
         EXPECT_EQ(expectedBoard, receivedBoard);
     }
 
-    static std::array<bool, 64> fenToOccupied(std::string const& shortFen) {
+    static chess::Bitboard fenToOccupied(std::string const& shortFen) {
         chess::Chess0x88 board;
         std::string fen = shortFen + " w - - 0 1";
         board.parse_fen(fen.c_str());
-        std::array<bool, 64> result{};
-        for (uint8_t square : board.getOccupiedSquares()) {
-            result[square] = true;
-        }
-        return result;
+        return board.getOccupancy();
     }
 
     std::map<eboard::StoneId, char> conversionMap{
@@ -105,10 +110,17 @@ class SentioTest : public ::testing::Test {
     }
 
   private:
+    static size_t const FRAMES_PER_OCCUPANCY = 8;
+    static int const FRAME_INTERVAL_MS = 15;
+    /** consecutive frames a move is resolved from, the default minimum of the debouncer */
+    static size_t const MOVE_FRAMES = 2;
+
     std::unique_ptr<Sentio> instance;
     std::array<eboard::StoneId, 64> receivedBoard{};
 };
 
+int const SentioTest::FRAME_INTERVAL_MS;
+
 TEST_F(SentioTest, initialPosition) {
     givenAnInstance();
     whenOccupiedIsCalledWith("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR");
@@ -269,6 +281,66 @@ TEST_F(SentioTest, takeBack_C) {
     thenLastReceivedBoardShouldBe("rnbqkbnr/ppp1pppp/8/3p4/4P3/8/PPPP1PPP/RNBQKBNR");
 }
 
+TEST_F(SentioTest, takeBackSeveralMoves) {
+    givenAnInstance();
+    givenOccupiedSquaresOfInitialPosition();
+    givenOccupiedIsCalledWith("rnbqkbnr/pppppppp/8/8/8/8/PPPP1PPP/RNBQKBNR");         // e2 up
+    givenOccupiedIsCalledWith("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR");       // e4 down
+    givenOccupiedIsCalledWith("rnbqkbnr/pppp1ppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR");       // e7 up
+    givenOccupiedIsCalledWith("rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR");     // e5 down
+    givenOccupiedIsCalledWith("rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKB1R");     // Ng1 up
+    givenOccupiedIsCalledWith("rnbqkbnr/pppp1ppp/8/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R");   // Nf3 down
+    givenOccupiedIsCalledWith("r1bqkbnr/pppp1ppp/8/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R");   // Nb8 up
+    givenOccupiedIsCalledWith("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R"); // Nc6 down
+
+    // take back Nb8c6 and Ng1f3 in one step
+    givenOccupiedIsCalledWith("r1bqkbnr/pppp1ppp/8/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R"); // Nc6 up
+    givenOccupiedIsCalledWith("r1bqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKB1R");   // Nf3 up
+    givenOccupiedIsCalledWith("rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKB1R");   // Nb8 down
+    whenOccupiedIsCalledWith("rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR");    // Ng1 down
+    thenLastReceivedBoardShouldBe("rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR");
+
+    // white is to move again
+    givenOccupiedIsCalledWith("rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQK1NR");  // Bf1 up
+    whenOccupiedIsCalledWith("rnbqkbnr/pppp1ppp/8/4p3/2B1P3/8/PPPP1PPP/RNBQK1NR"); // Bc4 down
+    thenLastReceivedBoardShouldBe("rnbqkbnr/pppp1ppp/8/4p3/2B1P3/8/PPPP1PPP/RNBQK1NR");
+}
+
+TEST_F(SentioTest, moveIsResolvedWhenThePieceIsPlaced) {
+    givenAnInstance();
+    givenOccupiedSquaresOfInitialPosition();
+    whenOccupiedIsCalledWithoutDelay("rnbqkbnr/pppppppp/8/8/8/8/PPPP1PPP/RNBQKBNR");   // e2 up
+    whenOccupiedIsCalledWithoutDelay("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR"); // e4 down
+    thenLastReceivedBoardShouldBe("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR");
+    whenOccupiedIsCalledWithoutDelay("rnbqkbnr/pppp1ppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR");   // e7 up
+    whenOccupiedIsCalledWithoutDelay("rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR"); // e5 down
+    thenLastReceivedBoardShouldBe("rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR");
+}
+
+TEST_F(SentioTest, misreadSquareWhilePieceIsLiftedIsNoMove) {
+    givenAnInstance();
+    givenOccupiedSquaresOfInitialPosition();
+    whenOccupiedIsCalledWithoutDelay("rnbqkbnr/pppppppp/8/8/8/8/PPPP1PPP/RNBQKBNR");      // e2 up
+    whenOccupiedIsCalledWithoutDelay("rnbqkbnr/pppppppp/8/8/8/4P3/PPPP1PPP/RNBQKBNR", 1); // e3 misread
+    whenOccupiedIsCalledWithoutDelay("rnbqkbnr/pppppppp/8/8/8/8/PPPP1PPP/RNBQKBNR");      // e2 still up
+    whenOccupiedIsCalledWithoutDelay("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR");    // e4 down
+    thenLastReceivedBoardShouldBe("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR");
+}
+
+TEST_F(SentioTest, captureIsResolvedWhenTheCapturingPieceIsPlaced) {
+    givenAnInstance();
+    givenOccupiedSquaresOfInitialPosition();
+    givenOccupiedIsCalledWith("rnbqkbnr/pppppppp/8/8/8/8/PPPP1PPP/RNBQKBNR");     // e2 up
+    givenOccupiedIsCalledWith("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR");   // e4 down
+    givenOccupiedIsCalledWith("rnbqkbnr/ppp1pppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR");   // d7 up
+    givenOccupiedIsCalledWith("rnbqkbnr/ppp1pppp/8/3p4/4P3/8/PPPP1PPP/RNBQKBNR"); // d5 down
+    whenOccupiedIsCalledWith("rnbqkbnr/ppp1pppp/8/3p4/8/8/PPPP1PPP/RNBQKBNR");    // e4 up
+    thenLastReceivedBoardShouldBe("rnbqkbnr/ppp1pppp/8/3p4/8/8/PPPP1PPP/RNBQKBNR");
+    whenOccupiedIsCalledWithoutDelay("rnbqkbnr/ppp1pppp/8/8/8/8/PPPP1PPP/RNBQKBNR");   // d5 up
+    whenOccupiedIsCalledWithoutDelay("rnbqkbnr/ppp1pppp/8/3P4/8/8/PPPP1PPP/RNBQKBNR"); // d5 down
+    thenLastReceivedBoardShouldBe("rnbqkbnr/ppp1pppp/8/3P4/8/8/PPPP1PPP/RNBQKBNR");
+}
+
 TEST_F(SentioTest, promoteToQueen) {
     givenAnInstance("r1bqkbnr/pPpppppp/8/8/8/8/PPP1PPPP/RNBQKBNR w KQkq");
     givenOccupiedIsCalledWith("r1bqkbnr/pPpppppp/8/8/8/8/PPP1PPPP/RNBQKBNR");
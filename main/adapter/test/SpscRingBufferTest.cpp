@@ -0,0 +1,77 @@
+#include <gmock/gmock.h>
+
+#include <thread>
+#include <vector>
+
+#include "SpscRingBuffer.h"
+
+using eboard::SpscRingBuffer;
+
+class SpscRingBufferTest : public ::testing::Test {
+  protected:
+    bool whenPushing(std::vector<uint8_t> const& data) {
+        return ring.push(data.data(), data.size());
+    }
+
+    std::vector<uint8_t> whenPopping(size_t max) {
+        std::vector<uint8_t> result(max);
+        result.resize(ring.pop(result.data(), max));
+        return result;
+    }
+
+    SpscRingBuffer<8> ring;
+};
+
+TEST_F(SpscRingBufferTest, bytesArePoppedInOrder) {
+    EXPECT_TRUE(ring.empty());
+    EXPECT_TRUE(whenPushing({1, 2, 3}));
+    EXPECT_FALSE(ring.empty());
+    EXPECT_EQ(std::vector<uint8_t>({1, 2}), whenPopping(2));
+    EXPECT_EQ(std::vector<uint8_t>({3}), whenPopping(8));
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST_F(SpscRingBufferTest, dataWrapsAround) {
+    whenPushing({1, 2, 3, 4, 5, 6});
+    whenPopping(6);
+    EXPECT_TRUE(whenPushing({7, 8, 9, 10, 11}));
+    EXPECT_EQ(std::vector<uint8_t>({7, 8, 9, 10, 11}), whenPopping(8));
+}
+
+TEST_F(SpscRingBufferTest, dataThatDoesNotFitIsDropped) {
+    EXPECT_TRUE(whenPushing({1, 2, 3, 4, 5, 6}));
+    EXPECT_FALSE(whenPushing({7, 8, 9}));
+    EXPECT_EQ(3, ring.dropped());
+    EXPECT_TRUE(whenPushing({7, 8}));
+    EXPECT_EQ(std::vector<uint8_t>({1, 2, 3, 4, 5, 6, 7, 8}), whenPopping(8));
+}
+
+TEST(SpscRingBufferThreadTest, consumerSeesAllBytesOfProducer) {
+    SpscRingBuffer<64> ring;
+    size_t const total = 100000;
+    std::thread producer([&ring]() {
+        for (size_t i = 0; i < total;) {
+            uint8_t value = i & 0xff;
+            if (ring.push(&value, 1)) {
+                i++;
+            } else {
+                // let the consumer run on a single CPU
+                std::this_thread::yield();
+            }
+        }
+    });
+    size_t received = 0;
+    bool inOrder = true;
+    uint8_t chunk[16];
+    while (received < total) {
+        size_t count = ring.pop(chunk, sizeof(chunk));
+        if (count == 0) {
+            std::this_thread::yield();
+        }
+        for (size_t i = 0; i < count; i++, received++) {
+            inOrder = inOrder && chunk[i] == (received & 0xff);
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(inOrder);
+}
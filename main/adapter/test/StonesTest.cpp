@@ -0,0 +1,76 @@
+#include <gmock/gmock.h>
+
+#include "ChessData.h"
+#include "Stones.h"
+
+using eboard::CertaboPiece;
+using eboard::ChessData;
+using eboard::PieceId;
+using eboard::StoneId;
+using eboard::Stones;
+
+class StonesTest : public ::testing::Test {
+  protected:
+    static CertaboPiece piece(uint8_t b0, uint8_t b1, uint8_t b2, uint8_t b3, uint8_t b4) {
+        return CertaboPiece(PieceId{b0, b1, b2, b3, b4});
+    }
+
+    Stones stones;
+};
+
+TEST_F(StonesTest, findInsertedStones) {
+    stones.insert(piece(48, 0, 248, 71, 99), ChessData::BLACK_ROOK);
+    stones.insert(piece(48, 0, 248, 85, 159), ChessData::BLACK_KNIGHT);
+    EXPECT_EQ(StoneId{ChessData::BLACK_ROOK}, stones.find(piece(48, 0, 248, 71, 99)));
+    EXPECT_EQ(StoneId{ChessData::BLACK_KNIGHT}, stones.find(piece(48, 0, 248, 85, 159)));
+    EXPECT_EQ(2, stones.size());
+}
+
+TEST_F(StonesTest, unknownPieceIsNoStone) {
+    stones.insert(piece(48, 0, 248, 71, 99), ChessData::BLACK_ROOK);
+    EXPECT_EQ(StoneId{ChessData::NO_STONE}, stones.find(piece(48, 0, 248, 71, 98)));
+}
+
+TEST_F(StonesTest, emptyPieceIsNeverAdded) {
+    stones.insert(piece(0, 0, 0, 0, 0), ChessData::WHITE_QUEEN);
+    EXPECT_TRUE(stones.empty());
+    EXPECT_EQ(StoneId{ChessData::NO_STONE}, stones.find(piece(0, 0, 0, 0, 0)));
+}
+
+TEST_F(StonesTest, fullSetOfPieces) {
+    for (uint8_t i = 1; i <= 34; i++) {
+        EXPECT_TRUE(stones.insert(piece(3, 0, 84, i, 255 - i), i));
+    }
+    for (uint8_t i = 1; i <= 34; i++) {
+        EXPECT_EQ(i, stones.find(piece(3, 0, 84, i, 255 - i)));
+    }
+}
+
+TEST_F(StonesTest, pieceKeyRoundTrip) {
+    PieceId id{3, 0, 84, 252, 153};
+    CertaboPiece pc(id);
+    EXPECT_EQ(0x030054fc99ULL, pc.getKey());
+    EXPECT_EQ(id, pc.getId());
+}
+
+TEST_F(StonesTest, serializedStonesAreRestored) {
+    stones.insert(piece(48, 0, 248, 71, 99), ChessData::BLACK_ROOK);
+    stones.insert(piece(3, 0, 84, 252, 153), ChessData::WHITE_KING);
+    std::vector<uint8_t> data = stones.serialize();
+    EXPECT_EQ(4 + 2 * 6, data.size());
+    Stones restored;
+    EXPECT_TRUE(restored.deserialize(data.data(), data.size()));
+    EXPECT_EQ(2, restored.size());
+    EXPECT_EQ(StoneId{ChessData::BLACK_ROOK}, restored.find(piece(48, 0, 248, 71, 99)));
+    EXPECT_EQ(StoneId{ChessData::WHITE_KING}, restored.find(piece(3, 0, 84, 252, 153)));
+}
+
+TEST_F(StonesTest, invalidSerializedStonesAreRejected) {
+    stones.insert(piece(48, 0, 248, 71, 99), ChessData::BLACK_ROOK);
+    std::vector<uint8_t> data = stones.serialize();
+    Stones restored;
+    EXPECT_FALSE(restored.deserialize(data.data(), data.size() - 1));
+    data[2] = 0; // unknown version
+    EXPECT_FALSE(restored.deserialize(data.data(), data.size()));
+    EXPECT_TRUE(restored.empty());
+}
@@ -0,0 +1,60 @@
+#include <gmock/gmock.h>
+
+#include "Trace.h"
+
+using eboard::TraceRecord;
+using eboard::TraceRecordType;
+using eboard::TraceWriter;
+
+class TraceTest : public ::testing::Test {
+  protected:
+    void whenRecordIsWritten(TraceRecordType type, uint64_t timeMicros, std::vector<uint8_t> const& data) {
+        writer.record(type, timeMicros, data.data(), data.size());
+    }
+
+    std::vector<TraceRecord> thenTraceCanBeDecoded() {
+        std::vector<TraceRecord> records;
+        EXPECT_TRUE(eboard::decodeTrace(trace, records));
+        return records;
+    }
+
+    std::vector<uint8_t> trace;
+    TraceWriter writer{[this](const uint8_t* data, size_t data_len) {
+        trace.insert(trace.end(), data, data + data_len);
+    }};
+};
+
+TEST_F(TraceTest, recordsAreDecoded) {
+    whenRecordIsWritten(TraceRecordType::BLE_WRITE, 1000000, {0x21, 0x01, 0x00});
+    whenRecordIsWritten(TraceRecordType::BLE_NOTIFY_INFO, 1000200, {0x23, 0x01, 0x00});
+    whenRecordIsWritten(TraceRecordType::USB_RX, 1300000, std::vector<uint8_t>(300, 0x30));
+    auto records = thenTraceCanBeDecoded();
+    ASSERT_EQ(3, records.size());
+    EXPECT_EQ(TraceRecordType::BLE_WRITE, records[0].type);
+    EXPECT_EQ(0, records[0].timeMicros);
+    EXPECT_EQ(std::vector<uint8_t>({0x21, 0x01, 0x00}), records[0].data);
+    EXPECT_EQ(TraceRecordType::BLE_NOTIFY_INFO, records[1].type);
+    EXPECT_EQ(200, records[1].timeMicros);
+    EXPECT_EQ(TraceRecordType::USB_RX, records[2].type);
+    EXPECT_EQ(300000, records[2].timeMicros);
+    EXPECT_EQ(300, records[2].data.size());
+}
+
+TEST_F(TraceTest, recordsAreCompact) {
+    whenRecordIsWritten(TraceRecordType::BLE_WRITE, 0, {0x21, 0x01, 0x00});
+    whenRecordIsWritten(TraceRecordType::BLE_WRITE, 100, {0x21, 0x01, 0x00});
+    // header, then type, one byte time delta, one byte length and data for each record
+    EXPECT_EQ(5 + 2 * (1 + 1 + 1 + 3), trace.size());
+}
+
+TEST_F(TraceTest, truncatedTraceIsInvalid) {
+    whenRecordIsWritten(TraceRecordType::USB_RX, 0, {0x3a, 0x30, 0x20});
+    trace.pop_back();
+    std::vector<TraceRecord> records;
+    EXPECT_FALSE(eboard::decodeTrace(trace, records));
+}
+
+TEST_F(TraceTest, unknownHeaderIsInvalid) {
+    std::vector<TraceRecord> records;
+    EXPECT_FALSE(eboard::decodeTrace({'C', '2', 'N', 'X', 1}, records));
+}
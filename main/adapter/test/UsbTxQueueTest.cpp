@@ -0,0 +1,70 @@
+#include <gmock/gmock.h>
+
+#include "UsbTxQueue.h"
+
+using eboard::UsbTxQueue;
+
+class UsbTxQueueTest : public ::testing::Test {
+  protected:
+    void givenTransferIsBlocked() {
+        std::lock_guard<std::mutex> guard(transferMutex);
+        blocked = true;
+    }
+
+    void whenTransferIsUnblocked() {
+        {
+            std::lock_guard<std::mutex> guard(transferMutex);
+            blocked = false;
+        }
+        transferCondition.notify_all();
+    }
+
+    bool whenSending(std::vector<uint8_t> const& frame) {
+        return queue.send(frame.data(), frame.size());
+    }
+
+    void thenTransferredFramesShouldBe(std::vector<std::vector<uint8_t>> const& expected) {
+        std::unique_lock<std::mutex> lock(transferMutex);
+        transferCondition.wait_for(lock, std::chrono::seconds(1),
+                                   [this, &expected]() { return transferred.size() >= expected.size(); });
+        EXPECT_EQ(expected, transferred);
+    }
+
+    size_t droppedFrames() {
+        return queue.dropped();
+    }
+
+  private:
+    std::mutex transferMutex;
+    std::condition_variable transferCondition;
+    bool blocked = false;
+    std::vector<std::vector<uint8_t>> transferred;
+    UsbTxQueue queue{[this](uint8_t* data, size_t data_len) {
+        std::unique_lock<std::mutex> lock(transferMutex);
+        transferred.emplace_back(data, data + data_len);
+        transferCondition.notify_all();
+        transferCondition.wait(lock, [this]() { return !blocked; });
+    }};
+};
+
+TEST_F(UsbTxQueueTest, frameIsTransferred) {
+    EXPECT_TRUE(whenSending({1, 2, 3}));
+    thenTransferredFramesShouldBe({{1, 2, 3}});
+}
+
+TEST_F(UsbTxQueueTest, latestFrameWinsWhileTransferIsInFlight) {
+    givenTransferIsBlocked();
+    whenSending({1});
+    thenTransferredFramesShouldBe({{1}});
+    whenSending({2});
+    whenSending({3});
+    whenTransferIsUnblocked();
+    thenTransferredFramesShouldBe({{1}, {3}});
+    EXPECT_EQ(1, droppedFrames());
+}
+
+TEST_F(UsbTxQueueTest, oversizedFrameIsRejected) {
+    EXPECT_FALSE(whenSending(std::vector<uint8_t>(UsbTxQueue::MAX_FRAME_SIZE + 1)));
+    EXPECT_FALSE(whenSending({}));
+    EXPECT_TRUE(whenSending(std::vector<uint8_t>(UsbTxQueue::MAX_FRAME_SIZE, 0xff)));
+}
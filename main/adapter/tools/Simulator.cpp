@@ -0,0 +1,554 @@
+/**
+ * cer2nut-sim runs the adapter on the host against a virtual Certabo board which plays the games of a PGN file.
+ *
+ *   cer2nut-sim [options] <pgn file>
+ *
+ *   --sentio        simulate a board without piece recognition, by default the board has RFID pieces
+ *   --fps <n>       frames per second sent by the board, 0 sends frames as fast as possible (default)
+ *   --hold <n>      frames sent for each step of a move, default 3
+ *   --noise <p>     probability that a frame misreads one random square, default 0
+ *   --seed <n>      seed for the noise and the USB chunk sizes, default 1
+ *   --out <file>    write the Chessnut notifications as hex lines to a file, e.g. a named pipe read by a client
+ *
+ * The RFID board is calibrated first, with the extra queens on d6 and d3. Each move is then played by lifting and
+ * placing pieces: a captured piece is removed first, castling moves the king before the rook. After every move the
+ * board sent to the app must show the position of the game, otherwise the rest of the game is skipped.
+ * Underpromotions, and promotions on an RFID board without an unused extra queen, cannot be played with the pieces
+ * of a real board, games are only played up to such a move.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Chess0x88.h"
+#include "ChessnutAdapter.h"
+#include "Profiler.h"
+
+using eboard::ProfileStage;
+using eboard::Profiler;
+
+struct Options {
+    bool sentio = false;
+    int fps = 0;
+    int hold = 3;
+    double noise = 0;
+    unsigned seed = 1;
+    std::string outFileName;
+    std::string pgnFileName;
+};
+
+struct Game {
+    std::vector<std::string> moves;
+};
+
+static bool isResult(std::string const& token) {
+    return token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*";
+}
+
+/**
+ * Reads the main line of all games, skipping tags, comments, variations and annotations.
+ */
+static std::vector<Game> readGames(std::istream& in) {
+    std::vector<Game> games;
+    Game game;
+    std::string token;
+    auto endToken = [&]() {
+        if (isResult(token)) {
+            games.push_back(game);
+            game = Game();
+        } else {
+            // move numbers like "12." or "12..." may be written without a space before the move
+            size_t start = token.find_first_not_of("0123456789.");
+            if (start != std::string::npos && token[0] != '$') {
+                game.moves.push_back(token.substr(start));
+            }
+        }
+        token.clear();
+    };
+    int variationDepth = 0;
+    char c;
+    while (in.get(c)) {
+        if (c == '{') {
+            endToken();
+            in.ignore(std::numeric_limits<std::streamsize>::max(), '}');
+        } else if (c == ';') {
+            endToken();
+            in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        } else if (c == '[' && variationDepth == 0) {
+            endToken();
+            in.ignore(std::numeric_limits<std::streamsize>::max(), ']');
+        } else if (c == '(') {
+            endToken();
+            variationDepth++;
+        } else if (c == ')') {
+            token.clear();
+            variationDepth = std::max(0, variationDepth - 1);
+        } else if (variationDepth > 0) {
+            continue;
+        } else if (std::isspace(static_cast<unsigned char>(c))) {
+            endToken();
+        } else {
+            token += c;
+        }
+    }
+    endToken();
+    if (!game.moves.empty()) {
+        games.push_back(game);
+    }
+    return games;
+}
+
+static int pieceOfLetter(char letter, int side) {
+    static std::string const LETTERS("PNBRQK");
+    size_t index = LETTERS.find(letter);
+    if (index == std::string::npos) {
+        return chess::e;
+    }
+    return static_cast<int>(index) + (side == chess::white ? chess::P : chess::p);
+}
+
+/**
+ * @return the legal move for a move in standard algebraic notation, 0 if there is no such move or it is ambiguous
+ */
+static uint32_t findSanMove(chess::Chess0x88& board, std::string san) {
+    int side = board.getSideToMove();
+    // checks, annotations and capture and promotion signs do not select the move
+    san.erase(std::remove_if(san.begin(), san.end(),
+                             [](char c) { return std::string("+#!?x=").find(c) != std::string::npos; }),
+              san.end());
+    if (san == "O-O" || san == "0-0" || san == "O-O-O" || san == "0-0-0") {
+        int rank = side == chess::white ? 56 : 0;
+        return board.find_move(rank + 4, rank + (san.size() == 3 ? 6 : 2), chess::e);
+    }
+    int promoted = chess::e;
+    if (san.size() > 2 && std::isupper(static_cast<unsigned char>(san.back()))) {
+        promoted = pieceOfLetter(san.back(), side);
+        san.pop_back();
+    }
+    int piece = pieceOfLetter(san[0], side);
+    if (piece != chess::e && san[0] != 'P') {
+        san.erase(0, 1);
+    } else {
+        piece = side == chess::white ? chess::P : chess::p;
+        if (san[0] == 'P') {
+            san.erase(0, 1);
+        }
+    }
+    if (san.size() < 2 || san[san.size() - 2] < 'a' || san[san.size() - 2] > 'h' || san.back() < '1' ||
+        san.back() > '8') {
+        return 0;
+    }
+    int to = ('8' - san.back()) * 8 + (san[san.size() - 2] - 'a');
+    std::string disambiguation = san.substr(0, san.size() - 2);
+    uint32_t found = 0;
+    for (int from = 0; from < 64; from++) {
+        if (board.getPiece(from) != piece) {
+            continue;
+        }
+        bool matches = true;
+        for (char c : disambiguation) {
+            matches = matches && (c >= 'a' && c <= 'h' ? from % 8 == c - 'a' : from / 8 == '8' - c);
+        }
+        uint32_t move = matches ? board.find_move(from, to, promoted) : 0;
+        if (move != 0) {
+            if (found != 0) {
+                return 0;
+            }
+            found = move;
+        }
+    }
+    return found;
+}
+
+/**
+ * Chessnut piece nibble of each piece of Chess0x88, used to check the boards sent to the app.
+ */
+static uint8_t chessnutPiece(int piece) {
+    static uint8_t const NIBBLES[] = {0, 7, 10, 9, 6, 11, 12, 4, 5, 3, 8, 1, 2, 0};
+    return NIBBLES[piece];
+}
+
+/**
+ * A Certabo board with physical pieces, each with its own RFID, sending frames of the pieces on its squares.
+ */
+class VirtualBoard {
+  public:
+    static int const NO_PIECE = -1;
+
+    explicit VirtualBoard(bool pieceRecognition) : pieceRecognition(pieceRecognition) {
+        chess::Chess0x88 start;
+        for (int square = 0; square < 64; square++) {
+            int piece = start.getPiece(square);
+            if (piece != chess::e) {
+                homeSquares.push_back(square);
+                addPiece(piece);
+            }
+        }
+        extraQueens[chess::white] = addPiece(chess::Q);
+        extraQueens[chess::black] = addPiece(chess::q);
+        setUp();
+    }
+
+    /** Put all pieces on their squares of the initial position, the extra queens beside the board. */
+    void setUp() {
+        squares.fill(NO_PIECE);
+        for (size_t i = 0; i < homeSquares.size(); i++) {
+            squares[homeSquares[i]] = static_cast<int>(i);
+        }
+        extraQueenUsed[chess::white] = extraQueenUsed[chess::black] = false;
+    }
+
+    /** Put the extra queens on d6 and d3 for calibration, or remove them. */
+    void placeExtraQueens(bool place) {
+        squares[19] = place ? extraQueens[chess::black] : NO_PIECE;
+        squares[43] = place ? extraQueens[chess::white] : NO_PIECE;
+    }
+
+    void lift(int square) {
+        squares[square] = NO_PIECE;
+    }
+
+    void place(int square, int piece) {
+        squares[square] = piece;
+    }
+
+    int pieceAt(int square) const {
+        return squares[square];
+    }
+
+    /**
+     * Take an extra queen for a promotion.
+     * @return the queen or NO_PIECE if it was used before
+     */
+    int takeExtraQueen(int side) {
+        if (extraQueenUsed[side]) {
+            return NO_PIECE;
+        }
+        extraQueenUsed[side] = true;
+        return extraQueens[side];
+    }
+
+    /**
+     * @param misreadSquare square read wrong in this frame, -1 for none
+     * @return the frame as sent via USB
+     */
+    std::string frame(int misreadSquare) const {
+        std::string result(":");
+        if (pieceRecognition) {
+            for (int square = 0; square < 64; square++) {
+                eboard::PieceId id{};
+                if (squares[square] != NO_PIECE) {
+                    id = ids[squares[square]];
+                }
+                if (square == misreadSquare) {
+                    // an occupied square reads empty, an empty one reads an unknown piece
+                    id = squares[square] != NO_PIECE ? eboard::PieceId{} : eboard::PieceId{48, 0, 1, 2, 3};
+                }
+                for (uint8_t value : id) {
+                    result += std::to_string(value) + " ";
+                }
+            }
+            result.pop_back();
+        } else {
+            for (int row = 0; row < 8; row++) {
+                uint8_t rowByte = 0;
+                for (int col = 0; col < 8; col++) {
+                    int square = row * 8 + col;
+                    bool occupied = (squares[square] != NO_PIECE) != (square == misreadSquare);
+                    // the most significant bit is the leftmost square of the row
+                    rowByte |= occupied ? 0x80 >> col : 0;
+                }
+                result += std::to_string(rowByte) + (row < 7 ? " " : "");
+            }
+        }
+        return result + "\r\n";
+    }
+
+  private:
+    int addPiece(int piece) {
+        auto index = static_cast<uint8_t>(ids.size());
+        ids.push_back(
+            eboard::PieceId{48, 0, static_cast<uint8_t>(100 + piece), index, static_cast<uint8_t>(index * 37)});
+        return index;
+    }
+
+    bool pieceRecognition;
+    // RFID of each piece, indexed by piece number
+    std::vector<eboard::PieceId> ids;
+    // initial square of each piece, except for the extra queens
+    std::vector<int> homeSquares;
+    int extraQueens[2];
+    bool extraQueenUsed[2];
+    // piece number on each square, square 0 is a8
+    std::array<int, 64> squares;
+};
+
+int const VirtualBoard::NO_PIECE;
+
+class Simulation {
+  public:
+    /** frames sent while the extra queens are on the board, the calibration needs at least 7 */
+    static int const CALIBRATION_FRAMES = 20;
+    /** frames sent after setting up a game, more than the longest debounce window of a Sentio board */
+    static int const SET_UP_FRAMES = 10;
+
+    explicit Simulation(Options const& options)
+        : options(options), board(!options.sentio), random(options.seed),
+          profiler([this]() { return elapsedMicros(); }),
+          adapter([](uint8_t*, size_t) {}, [this](uint8_t* data, size_t data_len, bool isBoardData) {
+              notify(data, data_len, isBoardData);
+          }) {
+        if (!options.outFileName.empty()) {
+            out.open(options.outFileName);
+        }
+    }
+
+    int run(std::vector<Game> const& games) {
+        Profiler::install(&profiler);
+        // the app switches to real time mode before it expects boards
+        uint8_t realTimeMode[] = {0x21, 0x01, 0x00};
+        adapter.fromBle(realTimeMode, sizeof(realTimeMode));
+        if (!options.sentio) {
+            board.placeExtraQueens(true);
+            sendFrames(CALIBRATION_FRAMES);
+            board.placeExtraQueens(false);
+        }
+        for (size_t i = 0; i < games.size(); i++) {
+            playGame(i + 1, games[i]);
+        }
+        Profiler::install(nullptr);
+        uint64_t micros = std::max<uint64_t>(1, elapsedMicros());
+        std::cout << profiler.report();
+        std::cout << games.size() << " games, " << moves << " moves, " << frames << " frames (" << bytes
+                  << " bytes) in " << micros / 1000.0 << " ms: " << frames * 1000000 / micros << " frames/s, "
+                  << moves * 1000000 / micros << " moves/s, " << boards << " boards sent" << std::endl;
+        std::cout << failedGames << " games failed, " << truncatedGames << " games stopped at an unplayable promotion"
+                  << std::endl;
+        return adapter.isReady() && failedGames == 0 ? 0 : 2;
+    }
+
+  private:
+    uint64_t elapsedMicros() const {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    void notify(uint8_t* data, size_t data_len, bool isBoardData) {
+        if (isBoardData) {
+            Profiler::mark(ProfileStage::NOTIFIED);
+            lastBoard.assign(data, data + data_len);
+            boards++;
+        }
+        if (out) {
+            out << (isBoardData ? "board " : "info ") << std::hex;
+            for (size_t i = 0; i < data_len; i++) {
+                out << std::setw(2) << std::setfill('0') << static_cast<int>(data[i]);
+            }
+            out << std::dec << std::endl;
+        }
+    }
+
+    /**
+     * Send the current pieces in a number of frames, split into USB transfers of random size.
+     */
+    void sendFrames(int count) {
+        std::uniform_real_distribution<double> noise(0, 1);
+        std::uniform_int_distribution<int> square(0, 63);
+        std::uniform_int_distribution<size_t> chunkSize(1, 64);
+        for (int i = 0; i < count; i++) {
+            if (options.fps > 0) {
+                std::this_thread::sleep_until(start + std::chrono::microseconds(frames * 1000000 / options.fps));
+            }
+            std::string frame = board.frame(noise(random) < options.noise ? square(random) : -1);
+            for (size_t pos = 0; pos < frame.size();) {
+                size_t len = std::min(chunkSize(random), frame.size() - pos);
+                Profiler::mark(ProfileStage::USB_RX);
+                adapter.fromUsb(reinterpret_cast<uint8_t const*>(frame.data() + pos), len);
+                pos += len;
+            }
+            frames++;
+            bytes += frame.size();
+        }
+    }
+
+    void lift(int square) {
+        board.lift(square);
+        sendFrames(options.hold);
+    }
+
+    void place(int square, int piece) {
+        board.place(square, piece);
+        sendFrames(options.hold);
+    }
+
+    /**
+     * Move the pieces of the board for a legal move of the position.
+     * @return false if the move cannot be played with the pieces of the board
+     */
+    bool playMove(chess::Chess0x88& position, uint32_t move) {
+        int from = get_move_source_64(move);
+        int to = get_move_target_64(move);
+        int promoted = get_move_piece(move);
+        int side = position.getSideToMove();
+        int piece = board.pieceAt(from);
+        if (promoted != chess::e) {
+            if (promoted != chess::Q && promoted != chess::q) {
+                return false;
+            }
+            if (!options.sentio) {
+                piece = board.takeExtraQueen(side);
+                if (piece == VirtualBoard::NO_PIECE) {
+                    return false;
+                }
+            }
+        }
+        if (get_move_enpassant(move)) {
+            lift(side == chess::white ? to + 8 : to - 8);
+        } else if (get_move_capture(move)) {
+            lift(to);
+        }
+        lift(from);
+        place(to, piece);
+        bool king = position.getPiece(from) == chess::K || position.getPiece(from) == chess::k;
+        if (king && (to - from == 2 || from - to == 2)) {
+            int rookFrom = to > from ? from + 3 : from - 4;
+            int rookTo = to > from ? from + 1 : from - 1;
+            int rook = board.pieceAt(rookFrom);
+            lift(rookFrom);
+            place(rookTo, rook);
+        }
+        return true;
+    }
+
+    /** @return whether the last board sent to the app shows the position */
+    bool boardMatches(chess::Chess0x88& position) const {
+        if (lastBoard.size() < 34) {
+            return false;
+        }
+        for (int square = 0; square < 64; square++) {
+            // the app's square 0 is a1, in the upper nibble of byte 33
+            int appSquare = (7 - square / 8) * 8 + square % 8;
+            uint8_t byte = lastBoard[33 - appSquare / 2];
+            uint8_t nibble = appSquare % 2 == 0 ? byte >> 4 : byte & 0x0f;
+            if (nibble != chessnutPiece(position.getPiece(square))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Keep sending the unchanged pieces until the last board sent to the app shows the position, a misread square of
+     * the last frame may still be shown.
+     * @return whether the board was sent within SET_UP_FRAMES frames
+     */
+    bool waitForBoard(chess::Chess0x88& position) {
+        for (int i = 0; i < SET_UP_FRAMES; i++) {
+            if (boardMatches(position)) {
+                return true;
+            }
+            sendFrames(1);
+        }
+        return boardMatches(position);
+    }
+
+    void playGame(size_t number, Game const& game) {
+        chess::Chess0x88 position;
+        board.setUp();
+        sendFrames(SET_UP_FRAMES);
+        if (!waitForBoard(position)) {
+            std::cout << "game " << number << ": initial position not sent" << std::endl;
+            failedGames++;
+            return;
+        }
+        for (size_t ply = 0; ply < game.moves.size(); ply++) {
+            std::string const& san = game.moves[ply];
+            uint32_t move = findSanMove(position, san);
+            if (move == 0) {
+                std::cout << "game " << number << ": illegal move " << ply / 2 + 1 << " " << san << std::endl;
+                failedGames++;
+                return;
+            }
+            if (!playMove(position, move)) {
+                truncatedGames++;
+                return;
+            }
+            position.make_move(move);
+            moves++;
+            if (!waitForBoard(position)) {
+                std::cout << "game " << number << ": board differs after move " << ply / 2 + 1 << " " << san
+                          << std::endl;
+                failedGames++;
+                return;
+            }
+        }
+    }
+
+    Options const& options;
+    VirtualBoard board;
+    std::mt19937 random;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    Profiler profiler;
+    eboard::ChessnutAdapter adapter;
+    std::ofstream out;
+    std::vector<uint8_t> lastBoard;
+    uint64_t frames = 0;
+    uint64_t bytes = 0;
+    uint64_t moves = 0;
+    uint64_t boards = 0;
+    size_t failedGames = 0;
+    size_t truncatedGames = 0;
+};
+
+static int usage() {
+    std::cerr << "usage: cer2nut-sim [--sentio] [--fps <n>] [--hold <n>] [--noise <p>] [--seed <n>] [--out <file>] "
+                 "<pgn file>"
+              << std::endl;
+    return 1;
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    Options options;
+    for (size_t i = 0; i < args.size(); i++) {
+        bool hasValue = i + 1 < args.size();
+        if (args[i] == "--sentio") {
+            options.sentio = true;
+        } else if (args[i] == "--fps" && hasValue) {
+            options.fps = std::stoi(args[++i]);
+        } else if (args[i] == "--hold" && hasValue) {
+            options.hold = std::max(1, std::stoi(args[++i]));
+        } else if (args[i] == "--noise" && hasValue) {
+            options.noise = std::stod(args[++i]);
+        } else if (args[i] == "--seed" && hasValue) {
+            options.seed = static_cast<unsigned>(std::stoul(args[++i]));
+        } else if (args[i] == "--out" && hasValue) {
+            options.outFileName = args[++i];
+        } else if (args[i][0] != '-' && options.pgnFileName.empty()) {
+            options.pgnFileName = args[i];
+        } else {
+            return usage();
+        }
+    }
+    if (options.pgnFileName.empty()) {
+        return usage();
+    }
+    std::ifstream in(options.pgnFileName);
+    if (!in) {
+        std::cerr << "cannot read " << options.pgnFileName << std::endl;
+        return 1;
+    }
+    std::vector<Game> games = readGames(in);
+    Simulation simulation(options);
+    return simulation.run(games);
+}
@@ -0,0 +1,200 @@
+/**
+ * cer2nut-trace converts traces recorded on the device and replays them into the adapter on the host.
+ *
+ *   cer2nut-trace import <console log> <trace file>   extract the TRACE lines of a console log
+ *   cer2nut-trace dump <trace file>                   print all records
+ *   cer2nut-trace replay [--realtime] <trace file>    feed USB and BLE input into the adapter and compare its
+ *                                                     notifications with the recorded ones
+ *
+ * Without --realtime the trace is replayed as fast as possible. Time based behaviour like the Sentio processing
+ * delay or the board keep-alive then differs from the recording.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ChessnutAdapter.h"
+#include "Trace.h"
+
+using eboard::TraceRecord;
+using eboard::TraceRecordType;
+
+static std::string const TRACE_PREFIX("TRACE:");
+
+static std::string toHex(std::vector<uint8_t> const& data) {
+    std::stringstream ss;
+    ss << std::hex;
+    for (uint8_t b : data) {
+        ss << std::setw(2) << std::setfill('0') << (int)b;
+    }
+    return ss.str();
+}
+
+static char const* typeName(TraceRecordType type) {
+    switch (type) {
+    case TraceRecordType::USB_RX:
+        return "usb<--";
+    case TraceRecordType::BLE_WRITE:
+        return "ble<--";
+    case TraceRecordType::BLE_NOTIFY_BOARD:
+        return "-->ble board";
+    case TraceRecordType::BLE_NOTIFY_INFO:
+        return "-->ble";
+    }
+    return "unknown";
+}
+
+static bool readTrace(char const* fileName, std::vector<TraceRecord>& records) {
+    std::ifstream in(fileName, std::ios::binary);
+    std::vector<uint8_t> trace((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (!in.good() && !in.eof()) {
+        std::cerr << "cannot read " << fileName << std::endl;
+        return false;
+    }
+    if (!eboard::decodeTrace(trace, records)) {
+        std::cerr << fileName << " is not a valid trace" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static int import(char const* logFileName, char const* traceFileName) {
+    std::ifstream in(logFileName);
+    std::ofstream out(traceFileName, std::ios::binary);
+    if (!in || !out) {
+        std::cerr << "cannot open files" << std::endl;
+        return 1;
+    }
+    std::string line;
+    size_t bytes = 0;
+    while (std::getline(in, line)) {
+        size_t pos = line.find(TRACE_PREFIX);
+        if (pos == std::string::npos) {
+            continue;
+        }
+        for (pos += TRACE_PREFIX.size(); pos + 1 < line.size() && std::isxdigit(line[pos]); pos += 2) {
+            out.put(static_cast<char>(std::stoi(line.substr(pos, 2), nullptr, 16)));
+            bytes++;
+        }
+    }
+    std::cout << bytes << " bytes written to " << traceFileName << std::endl;
+    return 0;
+}
+
+static int dump(char const* traceFileName) {
+    std::vector<TraceRecord> records;
+    if (!readTrace(traceFileName, records)) {
+        return 1;
+    }
+    for (auto const& record : records) {
+        std::printf("%10.3f ms %-12s %s\n", record.timeMicros / 1000.0, typeName(record.type),
+                    toHex(record.data).c_str());
+    }
+    return 0;
+}
+
+/**
+ * Compares notifications, ignoring the timestamp of board data and date/time responses.
+ */
+static bool sameNotification(TraceRecord const& expected, TraceRecord const& actual) {
+    if (expected.type != actual.type || expected.data.size() != actual.data.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < expected.data.size(); i++) {
+        bool boardTime = expected.type == TraceRecordType::BLE_NOTIFY_BOARD && i >= 34 && i < 38;
+        bool dateTime = expected.type == TraceRecordType::BLE_NOTIFY_INFO && expected.data[0] == 0x2d && i >= 2;
+        if (!boardTime && !dateTime && expected.data[i] != actual.data[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static int replay(char const* traceFileName, bool realtime) {
+    std::vector<TraceRecord> records;
+    if (!readTrace(traceFileName, records)) {
+        return 1;
+    }
+    std::vector<TraceRecord> expected;
+    std::vector<TraceRecord> actual;
+    auto start = std::chrono::steady_clock::now();
+    auto elapsedMicros = [&start]() {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    };
+    eboard::ChessnutAdapter adapter([](uint8_t*, size_t) {},
+                                    [&](uint8_t* data, size_t data_len, bool isBoardData) {
+                                        actual.push_back(TraceRecord{isBoardData ? TraceRecordType::BLE_NOTIFY_BOARD
+                                                                                 : TraceRecordType::BLE_NOTIFY_INFO,
+                                                                     elapsedMicros(),
+                                                                     std::vector<uint8_t>(data, data + data_len)});
+                                    });
+    for (auto& record : records) {
+        if (realtime) {
+            std::this_thread::sleep_until(start + std::chrono::microseconds(record.timeMicros));
+        }
+        switch (record.type) {
+        case TraceRecordType::USB_RX:
+            adapter.fromUsb(record.data.data(), record.data.size());
+            break;
+        case TraceRecordType::BLE_WRITE:
+            adapter.fromBle(record.data.data(), record.data.size());
+            break;
+        default:
+            expected.push_back(record);
+            break;
+        }
+    }
+    auto duration = elapsedMicros();
+
+    size_t differences = 0;
+    for (size_t i = 0; i < std::max(expected.size(), actual.size()); i++) {
+        if (i < expected.size() && i < actual.size() && sameNotification(expected[i], actual[i])) {
+            continue;
+        }
+        if (differences++ < 10) {
+            std::cout << "notification " << i << " differs" << std::endl;
+            if (i < expected.size()) {
+                std::cout << "  recorded: " << typeName(expected[i].type) << " " << toHex(expected[i].data) << std::endl;
+            }
+            if (i < actual.size()) {
+                std::cout << "  replayed: " << typeName(actual[i].type) << " " << toHex(actual[i].data) << std::endl;
+            }
+        }
+    }
+    std::cout << records.size() << " records replayed in " << duration / 1000.0 << " ms, " << expected.size()
+              << " notifications recorded, " << actual.size() << " replayed, " << differences << " differences"
+              << std::endl;
+    return differences == 0 ? 0 : 2;
+}
+
+static int usage() {
+    std::cerr << "usage: cer2nut-trace import <console log> <trace file>" << std::endl
+              << "       cer2nut-trace dump <trace file>" << std::endl
+              << "       cer2nut-trace replay [--realtime] <trace file>" << std::endl;
+    return 1;
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    if (args.size() == 3 && args[0] == "import") {
+        return import(argv[2], argv[3]);
+    } else if (args.size() == 2 && args[0] == "dump") {
+        return dump(argv[2]);
+    } else if (args.size() == 2 && args[0] == "replay") {
+        return replay(argv[2], false);
+    } else if (args.size() == 3 && args[0] == "replay" && args[1] == "--realtime") {
+        return replay(argv[3], true);
+    }
+    return usage();
+}
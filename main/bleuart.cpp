@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
@@ -28,9 +29,22 @@
 #include "services/gap/ble_svc_gap.h"
 #include "services/gatt/ble_svc_gatt.h"
 
+#include "adapter/lib/NotificationQueue.h"
+#include "adapter/lib/UsbTxQueue.h"
 #include "bleuart.h"
+#include "calibrationstore.h"
 #include "vcpusb.h"
 
+#ifdef CONFIG_CER2NUT_TRACE
+#include "adapter/lib/Trace.h"
+#include "esp_timer.h"
+#endif
+
+#ifdef CONFIG_CER2NUT_PROFILE
+#include "adapter/lib/Profiler.h"
+#include "esp_timer.h"
+#endif
+
 using ble::BleUart;
 
 uint16_t BleUart::g_bleuart_attr_read_handle = 0;
@@ -237,32 +251,90 @@ static std::string toHex(unsigned const char* data, int len) {
     return ss.str();
 }
 
-static void toUsb(uint8_t* data, size_t data_len) {
+#ifdef CONFIG_CER2NUT_TRACE
+static std::mutex traceMutex;
+// the trace is printed as hex lines, use "cer2nut-trace import" to convert a console log to a trace file
+static eboard::TraceWriter traceWriter([](const uint8_t* data, size_t data_len) {
+    printf("TRACE:%s\n", toHex(data, data_len).c_str());
+});
+
+static void trace(eboard::TraceRecordType type, const uint8_t* data, size_t data_len) {
+    std::lock_guard<std::mutex> guard(traceMutex);
+    traceWriter.record(type, esp_timer_get_time(), data, data_len);
+}
+#define TRACE(type, data, data_len) trace(eboard::TraceRecordType::type, data, data_len)
+#else
+#define TRACE(type, data, data_len)
+#endif
+
+#ifdef CONFIG_CER2NUT_PROFILE
+// the adapter library marks parse, translate and encode, USB receive and BLE notify are marked here
+static eboard::Profiler profiler([]() { return static_cast<uint64_t>(esp_timer_get_time()); });
+
+static void log_profile() {
+    std::istringstream lines(profiler.report());
+    std::string line;
+    while (std::getline(lines, line)) {
+        ESP_LOGI("PROFILE", "%s", line.c_str());
+    }
+}
+#define PROFILE(stage) eboard::Profiler::mark(eboard::ProfileStage::stage)
+#else
+#define PROFILE(stage)
+#endif
+
+static eboard::UsbTxQueue usbTxQueue([](uint8_t* data, size_t data_len) {
     std::lock_guard<std::mutex> guard(Usb::vcp_mutex);
-    if (data_len > 0 && Usb::vcp != nullptr) {
+    if (Usb::vcp != nullptr) {
         // std::cout << "-->usb:" << toHex(data, data_len) << std::endl;
-        Usb::vcp->tx_blocking(data, data_len, 1000);
+        Usb::vcp->tx_blocking(data, data_len, 250);
     }
+});
+
+static void toUsb(uint8_t* data, size_t data_len) {
+    usbTxQueue.send(data, data_len);
 }
 
+static eboard::NotificationQueue notificationQueue([](const uint8_t* data, size_t data_len, bool isBoardData) {
+    struct os_mbuf* om;
+    om = ble_hs_mbuf_from_flat(data, data_len);
+    if (!om) {
+        return eboard::NotifyResult::NO_BUFFER;
+    }
+    // the mbuf is freed by ble_gatts_notify_custom, also on failure
+    int rc = ble_gatts_notify_custom(BleUart::g_console_conn_handle,
+                                     isBoardData ? BleUart::g_bleuart_attr_board_read_handle
+                                                 : BleUart::g_bleuart_attr_read_handle,
+                                     om);
+    if (rc == BLE_HS_ENOMEM) {
+        return eboard::NotifyResult::NO_BUFFER;
+    }
+    if (rc == 0 && isBoardData) {
+        PROFILE(NOTIFIED);
+    }
+    return rc == 0 ? eboard::NotifyResult::SENT : eboard::NotifyResult::FAILED;
+});
+
 eboard::ChessnutAdapter BleUart::chessnutAdapter(eboard::ChessnutAdapter(
     [](uint8_t* data, size_t data_len) { toUsb(data, data_len); },
     [](uint8_t* data, size_t data_len, bool isBoardData) {
         if (connected) {
             // std::cout << "-->ble:" << toHex(data, data_len) << std::endl;
-            struct os_mbuf* om;
-            om = ble_hs_mbuf_from_flat(data, data_len);
-            if (!om) {
-                return;
-            }
             if (isBoardData) {
-                ble_gatts_notify_custom(g_console_conn_handle, g_bleuart_attr_board_read_handle, om);
+                TRACE(BLE_NOTIFY_BOARD, data, data_len);
             } else {
-                ble_gatts_notify_custom(g_console_conn_handle, g_bleuart_attr_read_handle, om);
+                TRACE(BLE_NOTIFY_INFO, data, data_len);
             }
+            notificationQueue.send(data, data_len, isBoardData);
         }
     }));
 
+// about one connection interval
+static int const NOTIFICATION_RETRY_MILLIS = 10;
+
+eboard::SpscRingBuffer<4096> BleUart::usbRxBuffer;
+TaskHandle_t BleUart::adapterTaskHandle = nullptr;
+
 BleUart::BleUart() {}
 
 int BleUart::bleuart_gap_event(struct ble_gap_event* event, void* arg) {
@@ -278,6 +350,8 @@ int BleUart::bleuart_gap_event(struct ble_gap_event* event, void* arg) {
             assert(rc == 0);
             g_console_conn_handle = event->connect.conn_handle;
             connected = true;
+            update_link_parameters(event->connect.conn_handle);
+            request_link_parameters(event->connect.conn_handle);
             if (chessnutAdapter.isReady()) {
                 chessnutAdapter.ledCommand({0, 0, 0, 0, 0, 0, 0, 0});
             }
@@ -295,12 +369,40 @@ int BleUart::bleuart_gap_event(struct ble_gap_event* event, void* arg) {
         ESP_LOGI("GAP", "Connection terminated; resume advertising");
         /* Connection terminated; resume advertising. */
         connected = false;
+        chessnutAdapter.setConnectionInterval(0);
+        notificationQueue.clear();
+        log_notification_counters();
+#ifdef CONFIG_CER2NUT_PROFILE
+        log_profile();
+#endif
         bleuart_advertise();
         if (chessnutAdapter.isReady()) {
             chessnutAdapter.ledCommand({0, 0, 0, 0x18, 0x18, 0, 0, 0});
         }
         return 0;
 
+    case BLE_GAP_EVENT_MTU:
+        ESP_LOGI("GAP", "MTU updated to %d", event->mtu.value);
+        update_link_parameters(event->mtu.conn_handle);
+        return 0;
+
+    case BLE_GAP_EVENT_CONN_UPDATE:
+        ESP_LOGI("GAP", "Connection update %s", event->conn_update.status == 0 ? "OK" : "FAILED");
+        update_link_parameters(event->conn_update.conn_handle);
+        return 0;
+
+    case BLE_GAP_EVENT_PHY_UPDATE_COMPLETE:
+        ESP_LOGI("GAP", "PHY update %s, tx PHY %d, rx PHY %d", event->phy_updated.status == 0 ? "OK" : "FAILED",
+                 event->phy_updated.tx_phy, event->phy_updated.rx_phy);
+        return 0;
+
+    case BLE_GAP_EVENT_NOTIFY_TX:
+        // raised from within ble_gatts_notify_custom, the adapter task sends the queued notifications
+        if (adapterTaskHandle != nullptr) {
+            xTaskNotifyGive(adapterTaskHandle);
+        }
+        return 0;
+
     case BLE_GAP_EVENT_ADV_COMPLETE:
         ESP_LOGI("GAP", "Advertising terminated; resume advertising");
         /* Advertising terminated; resume advertising. */
@@ -327,9 +429,85 @@ int BleUart::bleuart_gap_event(struct ble_gap_event* event, void* arg) {
     return 0;
 }
 
+void BleUart::request_link_parameters(uint16_t conn_handle) {
+    int rc = ble_gattc_exchange_mtu(conn_handle, nullptr, nullptr);
+    if (rc != 0) {
+        ESP_LOGW("GAP", "MTU exchange not started, rc=%d", rc);
+    }
+    // 7.5 - 15 ms connection interval (1.25 ms units), no latency, 4 s supervision timeout (10 ms units)
+    struct ble_gap_upd_params params = {
+        .itvl_min = 6,
+        .itvl_max = 12,
+        .latency = 0,
+        .supervision_timeout = 400,
+        .min_ce_len = 0,
+        .max_ce_len = 0,
+    };
+    rc = ble_gap_update_params(conn_handle, &params);
+    if (rc != 0) {
+        ESP_LOGW("GAP", "Connection update not started, rc=%d", rc);
+    }
+    rc = ble_gap_set_prefered_le_phy(conn_handle, BLE_GAP_LE_PHY_2M_MASK, BLE_GAP_LE_PHY_2M_MASK,
+                                     BLE_GAP_LE_PHY_CODED_ANY);
+    if (rc != 0) {
+        ESP_LOGW("GAP", "2M PHY not requested, rc=%d", rc);
+    }
+}
+
+void BleUart::update_link_parameters(uint16_t conn_handle) {
+    struct ble_gap_conn_desc desc;
+    if (ble_gap_conn_find(conn_handle, &desc) != 0) {
+        return;
+    }
+    int mtu = ble_att_mtu(conn_handle);
+    ESP_LOGI("GAP", "MTU %d, connection interval %d us", mtu, desc.conn_itvl * 1250);
+    chessnutAdapter.setConnectionInterval(desc.conn_itvl * 1250);
+}
+
+eboard::NotificationCounters BleUart::getNotificationCounters() {
+    return notificationQueue.getCounters();
+}
+
+void BleUart::log_notification_counters() {
+    eboard::NotificationCounters counters = notificationQueue.getCounters();
+    ESP_LOGI("GAP",
+             "Notifications sent %u, boards collapsed %u, no buffer %u, failed %u, overflows %u, "
+             "latency last %u us, max %u us",
+             counters.sent, counters.boardsCollapsed, counters.noBuffer, counters.failed, counters.overflows,
+             counters.lastLatencyMicros, counters.maxLatencyMicros);
+}
+
 void BleUart::notify(const uint8_t* data, size_t data_len) {
-    // std::cout << "usb<--:" << toHex(data, data_len) << std::endl;
-    chessnutAdapter.fromUsb(data, data_len);
+    if (!usbRxBuffer.push(data, data_len)) {
+        ESP_LOGW("USB", "Receive buffer full, %u bytes dropped", usbRxBuffer.dropped());
+    }
+    if (adapterTaskHandle != nullptr) {
+        xTaskNotifyGive(adapterTaskHandle);
+    }
+}
+
+void BleUart::adapter_task(void* param) {
+    static uint8_t data[512];
+    TickType_t wait = portMAX_DELAY;
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, wait);
+        size_t data_len;
+        while ((data_len = usbRxBuffer.pop(data, sizeof(data))) > 0) {
+            // std::cout << "usb<--:" << toHex(data, data_len) << std::endl;
+            TRACE(USB_RX, data, data_len);
+            // marked here and not in notify, a mark on the USB task would restart the frame the adapter parses
+            PROFILE(USB_RX);
+            chessnutAdapter.fromUsb(data, data_len);
+        }
+        // wake up again when a board held back by the connection interval is due
+        int pendingMillis = chessnutAdapter.sendPendingBoard();
+        wait = pendingMillis < 0 ? portMAX_DELAY : pdMS_TO_TICKS(pendingMillis) + 1;
+        // a transmitted notification does not free a buffer for sure, retry queued ones until they are sent
+        notificationQueue.flush();
+        if (notificationQueue.size() > 0) {
+            wait = std::min<TickType_t>(wait, pdMS_TO_TICKS(NOTIFICATION_RETRY_MILLIS) + 1);
+        }
+    }
 }
 
 int BleUart::gatt_svr_chr_access_uart_write(uint16_t conn_handle, uint16_t attr_handle,
@@ -339,6 +517,7 @@ int BleUart::gatt_svr_chr_access_uart_write(uint16_t conn_handle, uint16_t attr_
     case BLE_GATT_ACCESS_OP_WRITE_CHR:
         while (om) {
             // std::cout << "ble<--:" << toHex(ctxt->om->om_data, ctxt->om->om_len) << std::endl;
+            TRACE(BLE_WRITE, ctxt->om->om_data, ctxt->om->om_len);
             chessnutAdapter.fromBle(ctxt->om->om_data, ctxt->om->om_len);
             om = SLIST_NEXT(om, om_next);
         }
@@ -457,16 +636,34 @@ void BleUart::ble_task(void* arg) {
 
 void BleUart::init() {
     nvs_flash_init();
+    eboard::Stones stones;
+    if (CalibrationStore::load(stones)) {
+        chessnutAdapter.restoreCalibration(stones);
+    }
+    chessnutAdapter.setCalibrationStoreFunction(CalibrationStore::save);
+    chessnutAdapter.setHistoryDepth(CONFIG_CER2NUT_HISTORY_DEPTH);
+    eboard::DebounceSettings debounceSettings;
+    debounceSettings.settleTimeMs = CONFIG_CER2NUT_DEBOUNCE_SETTLE_MS;
+    debounceSettings.minFrames = CONFIG_CER2NUT_DEBOUNCE_MIN_FRAMES;
+    debounceSettings.maxFrames = CONFIG_CER2NUT_DEBOUNCE_MAX_FRAMES;
+    chessnutAdapter.setDebounceSettings(debounceSettings);
+#ifdef CONFIG_CER2NUT_PROFILE
+    eboard::Profiler::install(&profiler);
+#endif
     nimble_port_init();
     /* Initialize the BLE host. */
     ble_hs_cfg.sync_cb = BleUart::bleuart_advertise;
     ble_hs_cfg.store_status_cb = ble_store_util_status_rr;
+    // a board notification is 38 bytes, the default MTU only allows 20
+    ble_att_set_preferred_mtu(247);
     assert(bleuart_gatt_svr_init() == 0);
 
     /* Set the default device name. */
     assert(ble_svc_gap_device_name_set("Chessnut Air") == 0);
 
     nimble_port_freertos_init(BleUart::host_task); // Run the thread
+
+    xTaskCreate(BleUart::adapter_task, "adapter", 8192, nullptr, 5, &adapterTaskHandle);
 }
 
 bool BleUart::isConnected() { return BleUart::connected; }
\ No newline at end of file
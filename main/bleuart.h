@@ -1,6 +1,10 @@
 #include <cstdint>
 
 #include "adapter/lib/ChessnutAdapter.h"
+#include "adapter/lib/NotificationQueue.h"
+#include "adapter/lib/SpscRingBuffer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "host/ble_gap.h"
 #include "host/ble_gatt.h"
 
@@ -45,11 +49,22 @@ class BleUart {
     static void bleuart_advertise(void);
 
     void init();
+    /**
+     * Queue data received via USB for the adapter task. Called from the USB host callback, does not block.
+     */
     void notify(const uint8_t* data, size_t data_len);
     bool isConnected();
 
+    /** Counters of BLE notifications since start, they show a congested link */
+    static eboard::NotificationCounters getNotificationCounters();
+
   private:
     static eboard::ChessnutAdapter chessnutAdapter;
+    static eboard::SpscRingBuffer<4096> usbRxBuffer;
+    static TaskHandle_t adapterTaskHandle;
+
+    // Runs the adapter pipeline for data received via USB
+    static void adapter_task(void* param);
 
     // The infinite task
     static void host_task(void* param);
@@ -72,6 +87,17 @@ class BleUart {
     /** BLE event handling */
     static int bleuart_gap_event(struct ble_gap_event* event, void* arg);
 
+    /**
+     * Ask the central for a larger MTU, a short connection interval and 2M PHY.
+     * Failures are only logged, the connection then keeps the parameters chosen by the central.
+     */
+    static void request_link_parameters(uint16_t conn_handle);
+
+    static void log_notification_counters();
+
+    /** Log the current MTU and pass the connection interval to the adapter */
+    static void update_link_parameters(uint16_t conn_handle);
+
     void ble_task(void* arg);
 };
 } // namespace ble
@@ -0,0 +1,47 @@
+#include <vector>
+
+#include "esp_log.h"
+#include "nvs.h"
+
+#include "calibrationstore.h"
+
+static const char* TAG = "calibration";
+static const char* NAMESPACE = "cer2nut";
+static const char* KEY = "stones";
+
+bool CalibrationStore::load(eboard::Stones& stones) {
+    nvs_handle_t handle;
+    if (nvs_open(NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+        return false;
+    }
+    size_t length = 0;
+    bool loaded = false;
+    if (nvs_get_blob(handle, KEY, nullptr, &length) == ESP_OK) {
+        std::vector<uint8_t> data(length);
+        loaded = nvs_get_blob(handle, KEY, data.data(), &length) == ESP_OK && stones.deserialize(data.data(), length);
+    }
+    nvs_close(handle);
+    ESP_LOGI(TAG, "Stored calibration %s", loaded ? "loaded" : "not available");
+    return loaded;
+}
+
+void CalibrationStore::save(eboard::Stones const& stones) {
+    nvs_handle_t handle;
+    if (nvs_open(NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) {
+        return;
+    }
+    std::vector<uint8_t> data = stones.serialize();
+    // avoid flash wear when the same pieces are calibrated again
+    size_t length = 0;
+    if (nvs_get_blob(handle, KEY, nullptr, &length) == ESP_OK && length == data.size()) {
+        std::vector<uint8_t> stored(length);
+        if (nvs_get_blob(handle, KEY, stored.data(), &length) == ESP_OK && stored == data) {
+            nvs_close(handle);
+            return;
+        }
+    }
+    if (nvs_set_blob(handle, KEY, data.data(), data.size()) == ESP_OK && nvs_commit(handle) == ESP_OK) {
+        ESP_LOGI(TAG, "Calibration stored");
+    }
+    nvs_close(handle);
+}
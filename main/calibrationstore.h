@@ -0,0 +1,12 @@
+#pragma once
+
+#include "adapter/lib/Stones.h"
+
+/**
+ * Keeps the calibrated stones in NVS so that calibration survives a power interruption.
+ */
+class CalibrationStore {
+  public:
+    static bool load(eboard::Stones& stones);
+    static void save(eboard::Stones const& stones);
+};